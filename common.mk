@@ -13,6 +13,7 @@
 #    NOOPTTAG:     Endung, welche an die Verzeichnisse für Objekt- und
 #                  Abhängigkeitsdateien bei Debugversionen angehängt wird
 #    VERBOSETAG:   Endung ähnlich NOOPTTAG, nur für Builds mit Verboseausgaben
+#    TRACETAG:     Endung ähnlich NOOPTTAG, nur für Builds mit Event-Tracing
 #    ASM:          Zu benutzender Assembler
 #    CC/CXX:       Zu benutzender C/C++-Compiler
 #    AR:           Zu benutzender Archivierer
@@ -30,6 +31,7 @@ OBJDIR = ./build
 DEPDIR = ./dep
 NOOPTTAG = -noopt
 VERBOSETAG = -verbose
+TRACETAG = -trace
 SOLUTIONDIR = ./solution
 SOLUTIONPREFIX = musterloesung-m
 ASM = nasm
@@ -116,14 +118,17 @@ clean:
 	$(VERBOSE) rm -rf "$(OBJDIR)"
 	$(VERBOSE) rm -rf "$(OBJDIR)$(NOOPTTAG)"
 	$(VERBOSE) rm -rf "$(OBJDIR)$(VERBOSETAG)"
+	$(VERBOSE) rm -rf "$(OBJDIR)$(TRACETAG)"
 	@echo "RM		$(DEPDIR)"
 	$(VERBOSE) rm -rf "$(DEPDIR)"
 	$(VERBOSE) rm -rf "$(DEPDIR)$(NOOPTTAG)"
 	$(VERBOSE) rm -rf "$(DEPDIR)$(VERBOSETAG)"
+	$(VERBOSE) rm -rf "$(DEPDIR)$(TRACETAG)"
 	@echo "RM		$(ISODIR)"
 	$(VERBOSE) rm -rf "$(ISODIR)"
 	$(VERBOSE) rm -rf "$(ISODIR)$(NOOPTTAG)"
 	$(VERBOSE) rm -rf "$(ISODIR)$(VERBOSETAG)"
+	$(VERBOSE) rm -rf "$(ISODIR)$(TRACETAG)"
 
 # --------------------------------------------------------------------------
 # Rezept fuer rekursiven Aufruf mit deaktivierten Optimierungen
@@ -135,6 +140,11 @@ clean:
 %-verbose:
 	make OBJDIR="$(OBJDIR)$(VERBOSETAG)" DEPDIR="$(DEPDIR)$(VERBOSETAG)" ISODIR="$(ISODIR)$(VERBOSETAG)" OPTFLAGS="-DVERBOSE" $*
 
+# --------------------------------------------------------------------------
+# Rezept fuer rekursiven Aufruf mit aktiviertem Event-Tracing (siehe debug/trace.h)
+%-trace:
+	make OBJDIR="$(OBJDIR)$(TRACETAG)" DEPDIR="$(DEPDIR)$(TRACETAG)" ISODIR="$(ISODIR)$(TRACETAG)" OPTFLAGS="$(OPTFLAGS) -DTRACE" $*
+
 # --------------------------------------------------------------------------
 # Standardrezepte zum Ausfuehren und Debuggen
 # --------------------------------------------------------------------------
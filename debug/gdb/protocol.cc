@@ -430,10 +430,7 @@ int GDB_Stub::send_error_packet(char *buf, size_t buf_len, char error){
 /*** Hilfsmethoden für die Kommunikation ***/
 
 int GDB_Stub::writeString(const char *buf, size_t len){
-	while (len--)
-		if (write(*buf++) == -1)
-			return -1;
-	return 0;
+	return write(buf, len) == len ? 0 : -1;
 }
 
 int GDB_Stub::readString(char *buf, size_t buf_len, size_t len){
@@ -0,0 +1,102 @@
+// vim: set et ts=4 sw=4:
+
+#include "debug/log.h"
+#include "debug/output.h"
+#include "device/console.h"
+#include "machine/cpu.h"
+
+Log klog;
+
+Log_Stream::Log_Stream(uint8_t level) : cpu(system.getCPUID()), level(level) {}
+
+void Log_Stream::flush() {
+    klog.append(cpu, level, buffer, pos);
+    pos = 0;
+}
+
+void Log::append(uint8_t cpu, uint8_t level, const char *text, int len) {
+    if (len <= 0) {
+        return;
+    }
+
+    bool ints = CPU::disable_int();
+    Ring &r = ring[system.getCPUID()];
+    uint32_t head = r.head;
+    uint32_t tail = __atomic_load_n(&r.tail, __ATOMIC_ACQUIRE);
+
+    if (LOG_BUFFER_SIZE - (head - tail) < HEADER_SIZE + len) {
+        __atomic_fetch_add(&r.dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        r.data[head++ & (LOG_BUFFER_SIZE - 1)] = cpu;
+        r.data[head++ & (LOG_BUFFER_SIZE - 1)] = level;
+        r.data[head++ & (LOG_BUFFER_SIZE - 1)] = len;
+        for (int i = 0; i < len; i++) {
+            r.data[head++ & (LOG_BUFFER_SIZE - 1)] = text[i];
+        }
+        __atomic_store_n(&r.head, head, __ATOMIC_RELEASE);
+    }
+    CPU::restore_int(ints);
+}
+
+bool Log::read_record(Ring &r, uint8_t &cpu, uint8_t &level, char *text, uint8_t &len) {
+    uint32_t tail = r.tail;
+    if (tail == __atomic_load_n(&r.head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    cpu   = r.data[tail++ & (LOG_BUFFER_SIZE - 1)];
+    level = r.data[tail++ & (LOG_BUFFER_SIZE - 1)];
+    len   = r.data[tail++ & (LOG_BUFFER_SIZE - 1)];
+    for (int i = 0; i < len; i++) {
+        text[i] = r.data[tail++ & (LOG_BUFFER_SIZE - 1)];
+    }
+    __atomic_store_n(&r.tail, tail, __ATOMIC_RELEASE);
+    return true;
+}
+
+static CGA_Stream& window(uint8_t cpu) {
+    switch (cpu) {
+        case 0:  return dout_CPU0;
+        case 1:  return dout_CPU1;
+        case 2:  return dout_CPU2;
+        default: return dout_CPU3;
+    }
+}
+
+bool Log::drain() {
+    bool printed = false;
+    char text[256];
+    uint8_t cpu, level, len;
+
+    for (int i = 0; i < CPU_MAX; i++) {
+        Ring &r = ring[i];
+
+        while (read_record(r, cpu, level, text, len)) {
+            CGA_Stream &out = window(cpu);
+            if (level == ERROR) {
+                out << COLOR_LIGHT_RED;
+            }
+            for (int j = 0; j < len; j++) {
+                out << text[j];
+            }
+            out << COLOR_RESET << ::flush;
+
+            if (!r.mid_line) {
+                char prefix[] = "[cpu0] ";
+                prefix[4] += cpu;
+                console.print(prefix, sizeof(prefix) - 1);
+            }
+            console.print(text, len);
+            r.mid_line = text[len - 1] != '\n';
+
+            printed = true;
+        }
+
+        if (r.dropped != 0) {
+            uint32_t dropped = __atomic_exchange_n(&r.dropped, 0, __ATOMIC_RELAXED);
+            window(i) << "Log: " << dropped << " records dropped" << endl;
+        }
+    }
+
+    return printed;
+}
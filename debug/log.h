@@ -0,0 +1,177 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the asynchronous kernel log (Log, Log_Stream) and the
+ *  LOG_* macros.
+ *
+ *  Unlike DBG, which writes into the CGA debug windows right away, the LOG_*
+ *  macros only format their text into a stream on the stack and copy it into
+ *  a per-CPU buffer at the end of the statement. The LogThread later
+ *  prints it to the debug window of the originating CPU and to the serial
+ *  console, so logging from an interrupt handler or the scheduler never waits
+ *  for a device.
+ *
+ *  Messages below LOG_LEVEL are removed at compile time:
+ *
+ *      LOG_INFO << "RTC: init done (" << hz << "hz)" << endl;
+ */
+
+#pragma once
+
+#include "types.h"
+#include "object/o_stream.h"
+#include "machine/apicsystem.h"
+#include "debug/null_stream.h"
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+/*!
+ *  \def LOG_LEVEL
+ *  \brief Most verbose level that is still compiled in.
+ */
+#ifndef LOG_LEVEL
+#ifdef VERBOSE
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+/*!
+ *  \def LOG_BUFFER_SIZE
+ *  \brief Size of each per-CPU log buffer in bytes, must be a power of two.
+ */
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 4096
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR (Log_Stream(Log::ERROR).self())
+#else
+#define LOG_ERROR nullstream
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN (Log_Stream(Log::WARN).self())
+#else
+#define LOG_WARN nullstream
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO (Log_Stream(Log::INFO).self())
+#else
+#define LOG_INFO nullstream
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG (Log_Stream(Log::DEBUG).self())
+#else
+#define LOG_DEBUG nullstream
+#endif
+
+/*! \brief Output stream for a single log statement, which turns every
+ *  flush into a log record.
+ *  \ingroup debug
+ *
+ *  The LOG_* macros create a temporary stream on the stack, so the text of
+ *  a statement is collected privately and appended to the log in one step
+ *  at its endl or end: neither a prologue nor another thread logging on the
+ *  same CPU can end up in the middle of it. The record is shown in the debug
+ *  window of the CPU the statement started on.
+ *
+ *  The buffer must stay below 256 bytes, as a record stores its length in a
+ *  single byte; longer texts are split into several records.
+ */
+class Log_Stream : public Buffered_O_Stream<128> {
+    // Disallow copies and assignments.
+    Log_Stream(const Log_Stream&)            = delete;
+    Log_Stream& operator=(const Log_Stream&) = delete;
+
+    uint8_t cpu;
+    uint8_t level;
+
+public:
+    explicit Log_Stream(uint8_t level);
+
+    ~Log_Stream() {
+        flush();
+    }
+
+    // lets the macros use the temporary with the free operator<< as well.
+    Log_Stream& self() {
+        return *this;
+    }
+
+    void flush() override;
+
+    using O_Stream::operator<<;
+
+    // the log has no colors, but a caller might still use them.
+    O_Stream& operator <<(CGA_Screen::Attribute& attr) override {
+        (void) attr;
+        return *this;
+    }
+};
+
+/*! \brief Per-CPU single-producer/single-consumer byte rings holding the
+ *  log records.
+ *  \ingroup debug
+ *
+ *  The producer of a ring is always the CPU it belongs to, with interrupts
+ *  disabled while it appends a record. The only consumer is the LogThread.
+ *  Neither side takes a lock; they only exchange the head and tail indices.
+ *  If a ring is full, the record is dropped and counted.
+ */
+class Log {
+    // Disallow copies and assignments.
+    Log(const Log&)            = delete;
+    Log& operator=(const Log&) = delete;
+
+public:
+    enum Level : uint8_t {
+        ERROR = LOG_LEVEL_ERROR,
+        WARN  = LOG_LEVEL_WARN,
+        INFO  = LOG_LEVEL_INFO,
+        DEBUG = LOG_LEVEL_DEBUG,
+    };
+
+private:
+    static_assert((LOG_BUFFER_SIZE & (LOG_BUFFER_SIZE - 1)) == 0,
+                  "LOG_BUFFER_SIZE must be a power of two");
+
+    // a record is [cpu][level][length][text...]
+    static const uint32_t HEADER_SIZE = 3;
+
+    struct Ring {
+        char data[LOG_BUFFER_SIZE];
+        uint32_t head; // written by the producing CPU only
+        uint32_t tail; // written by the LogThread only
+        uint32_t dropped;
+        bool mid_line; // LogThread only: the last record did not end a line
+    } __attribute__((aligned(64)));
+
+    Ring ring[CPU_MAX];
+
+    bool read_record(Ring &r, uint8_t &cpu, uint8_t &level, char *text, uint8_t &len);
+
+public:
+    Log() : ring() {}
+
+    /*! \brief Appends a record to the ring of the current CPU.
+     *
+     *  Can be called from any context, including prologues.
+     *  \param cpu CPU whose debug window should show the text
+     */
+    void append(uint8_t cpu, uint8_t level, const char *text, int len);
+
+    /*! \brief Prints all pending records. Only called by the LogThread.
+     *  \return true if at least one record was printed
+     */
+    bool drain();
+};
+
+extern Log klog;
@@ -0,0 +1,105 @@
+// vim: set et ts=4 sw=4:
+
+#include "debug/trace.h"
+#include "object/o_stream.h"
+#include "device/console.h"
+#include "machine/clock.h"
+#include "user/shell/shell.h"
+
+Trace trace;
+
+const char *Trace::get_type_string(uint32_t type) {
+    switch (type) {
+    case context_switch: return "switch";
+    case ready:          return "ready";
+    case block:          return "block";
+    case wakeup:         return "wakeup";
+    case irq_entry:      return "irq_entry";
+    case irq_exit:       return "irq_exit";
+    case epilogue:       return "epilogue";
+    case bell_fire:      return "bell";
+    default:             return "???";
+    }
+}
+
+bool Trace::quiesce() {
+    bool was_enabled = __atomic_exchange_n(&enabled, false, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < CPU_MAX; i++) {
+        while (__atomic_load_n(&buffer[i].writing, __ATOMIC_ACQUIRE)) ;
+    }
+    return was_enabled;
+}
+
+void Trace::start() {
+    __atomic_store_n(&enabled, true, __ATOMIC_SEQ_CST);
+}
+
+void Trace::stop() {
+    quiesce();
+}
+
+void Trace::clear() {
+    bool was_enabled = quiesce();
+    for (int i = 0; i < CPU_MAX; i++) {
+        buffer[i].head = 0;
+    }
+    __atomic_store_n(&enabled, was_enabled, __ATOMIC_SEQ_CST);
+}
+
+void Trace::dump(O_Stream &out) {
+    bool was_enabled = quiesce();
+
+#ifdef TRACE
+    out << "# trace begin cpus=" << system.getNumberOfOnlineCPUs()
+        << " events=" << TRACE_EVENTS << " tsc_khz=" << Clock::tsc_khz() << endl;
+    for (unsigned int cpu = 0; cpu < system.getNumberOfOnlineCPUs(); cpu++) {
+        Buffer &b = buffer[cpu];
+        uint32_t first = (b.head > TRACE_EVENTS) ? b.head - TRACE_EVENTS : 0;
+        for (uint32_t i = first; i != b.head; i++) {
+            Event &e = b.events[i & (TRACE_EVENTS - 1)];
+            out << cpu << ' ' << hex << (uint32_t) (e.tsc >> 32) << ' '
+                << (uint32_t) e.tsc << ' ' << get_type_string(e.type) << ' '
+                << e.arg << dec << endl;
+        }
+    }
+    out << "# trace end" << endl;
+#else
+    out << "# tracing is disabled, build with -DTRACE" << endl;
+#endif
+
+    __atomic_store_n(&enabled, was_enabled, __ATOMIC_SEQ_CST);
+}
+
+// Writes to the serial console through a buffer of its own: the dump takes
+// a while, and must neither hold the guard nor share the buffer of console.
+class Serial_Stream : public Buffered_O_Stream<128> {
+    // Disallow copies and assignments.
+    Serial_Stream(const Serial_Stream&)            = delete;
+    Serial_Stream& operator=(const Serial_Stream&) = delete;
+
+public:
+    Serial_Stream() {}
+
+    void flush() override {
+        console.print(buffer, pos);
+        pos = 0;
+    }
+};
+
+SHELL_COMMAND(trace, "[dump|clear|on|off]: controls the event tracer") {
+    StringView subcmd = ctx.args.tok(" ");
+
+    if (subcmd.empty() || streq(subcmd, "dump")) {
+        Serial_Stream serial;
+        trace.dump(serial);
+        ctx.out << "trace dumped to serial console" << endl;
+    } else if (streq(subcmd, "clear")) {
+        trace.clear();
+    } else if (streq(subcmd, "on")) {
+        trace.start();
+    } else if (streq(subcmd, "off")) {
+        trace.stop();
+    } else {
+        ctx.error("usage: trace [dump|clear|on|off]");
+    }
+}
@@ -0,0 +1,132 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the binary event tracer (Trace).
+ *
+ *  Tracing is compiled in with `-DTRACE` (see the `-trace` make targets).
+ *  Otherwise, TRACE_EVENT() expands to nothing and the hot paths stay as
+ *  they are.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "machine/cpu.h"
+#include "machine/apicsystem.h"
+
+class O_Stream;
+
+/*!
+ *  \def TRACE_EVENTS
+ *  \brief Number of events per CPU, must be a power of two.
+ */
+#ifndef TRACE_EVENTS
+#ifdef TRACE
+#define TRACE_EVENTS 2048
+#else
+#define TRACE_EVENTS 1
+#endif
+#endif
+
+/*!
+ *  \def TRACE_EVENT(TYPE, ARG)
+ *  \brief Record an event of type Trace::TYPE with the argument ARG.
+ */
+#ifdef TRACE
+#define TRACE_EVENT(TYPE, ARG) trace.record(Trace::TYPE, (uint32_t) (ARG))
+#else
+#define TRACE_EVENT(TYPE, ARG) do { } while (0)
+#endif
+
+/*! \brief Per-CPU ring buffers of compact, TSC-stamped kernel events.
+ *  \ingroup debug
+ *
+ *  Each CPU only ever writes into its own buffer, so recording needs no lock;
+ *  interrupts are disabled for the few instructions it takes to fill a slot.
+ *  When a buffer is full, the oldest events are overwritten. Dumping and
+ *  clearing stop recording and wait for events still being written on other
+ *  CPUs, so they see the buffers at rest without taking the guard.
+ *
+ *  The buffers are dumped as text (one event per line) and can be converted
+ *  into the Chrome trace format with `tools/trace2json.py`.
+ */
+class Trace {
+    // Disallow copies and assignments.
+    Trace(const Trace&)            = delete;
+    Trace& operator=(const Trace&) = delete;
+
+public:
+    enum Type : uint32_t {
+        context_switch = 1, // arg: next thread
+        ready,              // arg: thread
+        block,              // arg: thread
+        wakeup,             // arg: thread
+        irq_entry,          // arg: vector
+        irq_exit,           // arg: vector
+        epilogue,           // arg: gate
+        bell_fire,          // arg: bell
+    };
+
+    static const char *get_type_string(uint32_t type);
+
+private:
+    static_assert((TRACE_EVENTS & (TRACE_EVENTS - 1)) == 0,
+                  "TRACE_EVENTS must be a power of two");
+
+    struct Event {
+        uint64_t tsc;
+        uint32_t type;
+        uint32_t arg;
+    } __attribute__((packed));
+
+    struct Buffer {
+        Event events[TRACE_EVENTS];
+        uint32_t head; // total number of recorded events
+        bool writing;  // record() is filling a slot
+    } __attribute__((aligned(64)));
+
+    Buffer buffer[CPU_MAX];
+    bool enabled;
+
+    // stops recording and waits until no CPU is in record() anymore.
+    // \return whether recording was enabled before
+    bool quiesce();
+
+public:
+    Trace() : buffer(), enabled(true) {}
+
+    /*! \brief Appends an event to the buffer of the current CPU.
+     */
+    void record(Type type, uint32_t arg) {
+        if (!__atomic_load_n(&enabled, __ATOMIC_RELAXED)) {
+            return;
+        }
+
+        bool ints = CPU::disable_int();
+        Buffer &b = buffer[system.getCPUID()];
+        // pairs with quiesce(): either it sees "writing", or this sees
+        // that recording has been stopped.
+        __atomic_store_n(&b.writing, true, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&enabled, __ATOMIC_SEQ_CST)) {
+            Event &e = b.events[b.head & (TRACE_EVENTS - 1)];
+            e.tsc  = CPU::rdtsc();
+            e.type = type;
+            e.arg  = arg;
+            b.head++;
+        }
+        __atomic_store_n(&b.writing, false, __ATOMIC_RELEASE);
+        CPU::restore_int(ints);
+    }
+
+    void start();
+    void stop();
+    void clear();
+
+    /*! \brief Writes all buffered events to \b out, oldest first per CPU.
+     *
+     *  Recording is paused while dumping.
+     */
+    void dump(O_Stream &out);
+};
+
+extern Trace trace;
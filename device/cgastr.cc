@@ -2,6 +2,7 @@
 
 #include "device/cgastr.h"
 #include "debug/output.h"
+#include "object/scrollback.h"
 
 // global constructor order is important here!
 DECL_COLOR(BLACK);
@@ -24,7 +25,8 @@ DECL_COLOR(BLACK, LIGHT_GREY);
 
 CGA_Screen::Attribute COLOR_RESET(CGA_Screen::WHITE, CGA_Screen::WHITE, true); // invalid color
 
-CGA_Stream kout(0,  79,  0, 14, true);
+static Scrollback kout_history;
+CGA_Stream kout(0,  79,  0, 14, true, CGA_Screen::Attribute(), &kout_history);
 Guarded_Mutex kout_mutex;
 
 CGA_Stream dout_CPU0(0,  39, 15, 19, false, COLOR_LIGHT_BLUE);
@@ -42,6 +44,10 @@ void CGA_Stream::flush() {
     pos = 0;
 }
 
+void CGA_Stream::write_span(const char *s, size_t len) {
+    print(s, len, attrib);
+}
+
 void CGA_Stream::reset(char c) {
     CGA_Screen::reset(c, attrib);
 }
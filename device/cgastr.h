@@ -26,7 +26,7 @@
  *  flush() implementiert werden. Für weitergehende Formatierung oder spezielle
  *  Effekte stehen die Methoden der Klasse CGA_Screen zur Verfügung.
  */
-class CGA_Stream : public O_Stream, public CGA_Screen {
+class CGA_Stream : public Buffered_O_Stream<160>, public CGA_Screen {
 	// Verhindere Kopien und Zuweisungen
 	CGA_Stream(const CGA_Stream&)            = delete;
 	CGA_Stream& operator=(const CGA_Stream&) = delete;
@@ -36,10 +36,11 @@ private:
     Attribute attrib;
 
 public:
-    /// \copydoc CGA_Screen::CGA_Screen(int, int, int, int, bool)
+    /// \copydoc CGA_Screen::CGA_Screen(int, int, int, int, bool, Scrollback*)
 	CGA_Stream(int from_col, int to_col, int from_row, int to_row,
-        bool use_cursor = false, Attribute attr = Attribute()) : CGA_Screen(from_col, to_col,
-        from_row, to_row, use_cursor), orig_attrib(attr), attrib(attr) {
+        bool use_cursor = false, Attribute attr = Attribute(), Scrollback *history = nullptr)
+        : CGA_Screen(from_col, to_col, from_row, to_row, use_cursor, history),
+          orig_attrib(attr), attrib(attr) {
             CGA_Screen::reset(' ', attrib);
         }
 
@@ -52,6 +53,10 @@ public:
 	 */
 	virtual void flush() override;
 
+	/*! \brief Gibt lange Zeichenketten direkt mit CGA_Screen::print() aus.
+	 */
+	void write_span(const char *s, size_t len) override;
+
     void reset(char c = ' ');
 
     // "pos" is the position in "str" that will be erased by the backspace.
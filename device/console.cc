@@ -2,15 +2,26 @@
 
 #include "console.h"
 #include "debug/output.h"
+#include "debug/log.h"
 #include "machine/plugbox.h"
 #include "machine/ioapic.h"
 #include "object/bbuffer.h"
+#include "machine/spinlock.h"
+#include "machine/cpu.h"
+#include "thread/workqueue.h"
 
 Console console;
-static BBuffer<char, 64> buf;
+// receive ring; the prologue may run on any CPU, the epilogue empties it
+static MPMC_BBuffer<char, 1024> buf;
+
+// transmit ring, filled by print() on any CPU and drained by the prologue
+static const unsigned TX_SIZE = 4096;
+static char tx_buf[TX_SIZE];
+static unsigned tx_head, tx_tail;
+static Spinlock tx_lock;
 
 Console::Console(Serial::comPort port, Serial::baudRate baudrate, Serial::dataBits databits, Serial::stopBits stopbits, Serial::parity parity) :
-    Console::Serial(port, baudrate, databits, stopbits, parity) {
+    Console::Serial(port, baudrate, databits, stopbits, parity), listening(false) {
     setpos(0, 0);
     setForeground(WHITE);
     setBackground(BLACK);
@@ -87,29 +98,88 @@ bool Console::getpos(int& x, int& y) {
     return true;
 }
 
-void Console::print(char* string, int length) {
+void Console::tx_put(char c) {
+    if (tx_head - tx_tail == TX_SIZE) {
+        while (!canWrite()) ;
+        tx_fill();
+    }
+    tx_buf[tx_head++ % TX_SIZE] = c;
+}
+
+bool Console::tx_fill() {
+    for (unsigned i = 0; i < FIFO_SIZE && tx_tail != tx_head; i++) {
+        writeFifo(tx_buf[tx_tail++ % TX_SIZE]);
+    }
+    return tx_tail == tx_head;
+}
+
+void Console::write_span(const char *s, size_t len) {
+    print(s, len);
+}
+
+void Console::print(const char* string, int length) {
+    bool ints = CPU::disable_int();
+    tx_lock.lock();
+
     for (int i = 0; i < length; i++) {
 		if (string[i] == '\n' && i > 0 && string[i - 1] != '\r' ) {
-			write('\r');
+			tx_put('\r');
         }
-        write(string[i], true);
+        tx_put(string[i]);
+    }
+
+    if (listening) {
+        // raises an interrupt right away if the FIFO is already empty
+        transmitInterrupt(true);
+    } else {
+        do {
+            while (!canWrite()) ;
+        } while (!tx_fill());
     }
+
+    tx_lock.unlock();
+    CPU::restore_int(ints);
 }
 
 bool Console::prologue() {
-    int c = read(false);
-    if (c == -1) {
-        return false;
-    }
-    if (!buf.produce(c)) {
-        DBG << "Console: bbuffer full :(" << endl;
+    bool received = false;
+
+    for (;;) {
+        switch (pendingInterrupt()) {
+        case IID_NONE:
+            return received;
+        case IID_TX_EMPTY:
+            tx_lock.lock();
+            if (tx_fill()) {
+                transmitInterrupt(false);
+            }
+            tx_lock.unlock();
+            break;
+        case IID_RX_DATA:
+        case IID_RX_TIMEOUT:
+            int c;
+            while ((c = read(false)) != -1) {
+                if (!buf.produce(c)) {
+                    LOG_WARN << "Console: receive buffer full :(" << endl;
+                }
+                received = true;
+            }
+            break;
+        case IID_LINE:
+            lineStatus();
+            break;
+        default: // modem status interrupts are never enabled
+            return received;
+        }
     }
-    return true;
 }
 
-void Console::epilogue() {
+// Echoes the received characters in a worker thread, where taking
+// kout_mutex is allowed and the epilogues of others do not have to wait.
+static void echo(void *) {
     char c;
 
+    kout_mutex.lock();
     while (buf.consume(c)) {
         // on real hardware, a '\r\n' is created, so the '\r' needs to be ignored.
         // in kvm, only a '\r' is created, so it needs to be replaced by a '\n'.
@@ -120,6 +190,13 @@ void Console::epilogue() {
         }
     }
     kout << ::flush;
+    kout_mutex.unlock();
+}
+
+static Work echo_work(echo);
+
+void Console::epilogue() {
+    ordered_workqueue.submit(&echo_work);
 }
 
 void Console::listen() {
@@ -137,4 +214,13 @@ void Console::listen() {
     plugbox.assign(console_vector, this);
     ioapic.config(console_slot, console_vector, TRIGGER_MODE_LEVEL);
     receiveInterrupt(true);
+
+    bool ints = CPU::disable_int();
+    tx_lock.lock();
+    listening = true;
+    if (tx_tail != tx_head) {
+        transmitInterrupt(true);
+    }
+    tx_lock.unlock();
+    CPU::restore_int(ints);
 }
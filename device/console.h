@@ -23,13 +23,28 @@
  */
 
 class Console
-	: public O_Stream, public Serial, public Gate
+	: public Buffered_O_Stream<256>, public Serial, public Gate
 {
 private:
 	/*! \brief Mehrstellige Zahl als ASCII schreiben
 	 */
 	void write_number(int x);
 
+	/*! \brief Gibt an, ob die Ausgabe über Unterbrechungen erfolgt (siehe listen())
+	 */
+	bool listening;
+
+	/*! \brief Fügt ein Zeichen in den Sendepuffer ein. Ist dieser voll, wird
+	 *  er aktiv geleert. Der Sendepuffer muss gesperrt sein.
+	 */
+	void tx_put(char c);
+
+	/*! \brief Schreibt bis zu Serial::FIFO_SIZE Zeichen aus dem Sendepuffer
+	 *  in den (leeren) Sende-FIFO. Der Sendepuffer muss gesperrt sein.
+	 *  \return \c true, falls der Sendepuffer danach leer ist
+	 */
+	bool tx_fill();
+
 public:
 	/*! \brief Attribtue
 	 *
@@ -148,16 +163,27 @@ public:
 	 *  wird der Parameter \p length benötigt, der angeben muss, aus wievielen Zeichen
 	 *  string besteht.
 	 *
-	 *  \opt Methode implementieren
+	 *  Die Zeichen werden in einen Sendepuffer kopiert, welcher nach listen()
+	 *  über die Unterbrechung bei leerem Sende-FIFO geleert wird. Vorher
+	 *  wird synchron gesendet.
 	 *
 	 *  \param string Auszugebende Zeichenkette
 	 *  \param length Länge der Zeichenkette
 	 */
-	void print (char* string, int length);
+	void print (const char* string, int length);
+
+	/*! \brief Übergibt lange Zeichenketten direkt an print().
+	 */
+	void write_span(const char *s, size_t len) override;
 
+	/*! \brief Behandelt empfangene Zeichen und leere Sende-FIFOs.
+	 *  \return \c true, falls Zeichen empfangen wurden
+	 */
     bool prologue() override;
     void epilogue() override;
 
+	/*! \brief Aktiviert die Unterbrechungen für Empfang und Versand.
+	 */
     void listen();
 };
 
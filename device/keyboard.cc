@@ -28,7 +28,8 @@ bool Keyboard::prologue() {
             reboot();
         }
 
-        if (prebuf.produce(k)) {
+        if (buf.produce(k)) {
+            __atomic_fetch_add(&pending, 1, __ATOMIC_RELEASE);
             ret = true;
         }
     }
@@ -37,9 +38,7 @@ bool Keyboard::prologue() {
 }
 
 void Keyboard::epilogue() {
-    Key k;
-    while (prebuf.consume(k)) {
-        buf.produce(k);
+    for (unsigned n = __atomic_exchange_n(&pending, 0, __ATOMIC_ACQUIRE); n > 0; n--) {
         sem.v();
     }
 }
@@ -47,7 +46,17 @@ void Keyboard::epilogue() {
 Key Keyboard::getkey() {
     sem.p();
     Key k;
-    buf.consume(k);
+    // the key is in the buffer, but a prologue on another CPU may still be
+    // writing one in front of it.
+    while (!buf.consume(k)) ;
+    return k;
+}
+
+Key Keyboard::getkey(unsigned int ms) {
+    Key k;
+    if (sem.p_timeout(ms)) {
+        while (!buf.consume(k)) ;
+    }
     return k;
 }
 
@@ -61,6 +70,13 @@ size_t Keyboard::read(String *s, size_t count, CGA_Stream& out) {
             break;
         }
 
+        // shift + page up/down browses the scrollback of the window
+        if (k.SHIFT() && (k.scancode() == Key::scan::pgup || k.scancode() == Key::scan::pgdn)) {
+            int lines = out.height / 2;
+            out.scroll(k.scancode() == Key::scan::pgup ? lines : -lines);
+            continue;
+        }
+
         // catch backspace
         if (k.ascii() == '\b') {
             out.backspace(s);
@@ -30,15 +30,17 @@ class Keyboard
 	Keyboard& operator=(const Keyboard&) = delete;
 
 private:
-    BBuffer<Key, 64> prebuf;
-    BBuffer<Key, 64> buf;
+    // filled by the prologue (on whichever CPU it runs) and emptied by
+    // getkey() directly; the epilogue only v()s one unit per new key.
+    MPMC_BBuffer<Key, 64> buf;
+    unsigned pending;
     Semaphore sem;
 
 public:
 	/*! \brief Konstruktor
 	 *
 	 */
-	Keyboard() : sem(0) {}
+	Keyboard() : pending(0), sem(0) {}
 
 	/*! \brief 'Anstöpseln' der Tastatur.
 	 *
@@ -58,6 +60,10 @@ public:
 
     Key getkey();
 
+    // like getkey(), but waits at most "ms" milliseconds (0: not at all) and
+    // returns an invalid key if none came.
+    Key getkey(unsigned int ms);
+
     size_t read(String *s, size_t count, CGA_Stream& out = kout);
 
     Keyboard& operator >>(char &c);
@@ -3,6 +3,8 @@
 #include "device/watch.h"
 #include "machine/plugbox.h"
 #include "machine/lapic.h"
+#include "machine/clock.h"
+#include "machine/cpu.h"
 #include "utils/math.h"
 #include "debug/output.h"
 #include "thread/scheduler.h"
@@ -12,7 +14,8 @@
 Watch watch;
 
 bool Watch::windup(uint32_t us) {
-    uint64_t tmp = Math::div64((uint64_t) us * lapic.timer_ticks(), 1000); // ticks between IRQs
+    uint32_t ticks = lapic.timer_ticks(); // per ms
+    uint64_t tmp = Math::div64((uint64_t) us * ticks, 1000); // ticks between IRQs
     int shift = 0;
     while (tmp >> (32 + shift) != 0) {
         if (++shift > 7) {
@@ -25,21 +28,74 @@ bool Watch::windup(uint32_t us) {
     irq_interval = us;
     initial_count = tmp >> shift;
     divide = 1 << shift;
+    interval_ns = (uint64_t) us * 1000;
+    count_mult = (uint32_t) Math::div64((uint64_t) ticks << 16, 1000000 * divide);
+    if (count_mult == 0) {
+        count_mult = 1;
+    }
     //DBG << "Watch: initial_count: " << initial_count << ", divide: " << int(divide) << endl;
 
     plugbox.assign(Plugbox::Vector::timer, this);
     return true;
 }
 
+void Watch::arm(uint64_t now) {
+    int cpu = system.getCPUID();
+    uint64_t next = next_tick[cpu];
+    // a bell that is already due waits for the epilogue, which sets the
+    // next one; programming it again would only cause an interrupt storm.
+    if (next_hires[cpu] > now && next_hires[cpu] < next) {
+        next = next_hires[cpu];
+    }
+
+    uint64_t delta = next > now ? next - now : 0;
+    if (delta > interval_ns) {
+        delta = interval_ns;
+    }
+    // round up, an interrupt that comes too early is wasted
+    uint32_t count = (uint32_t) ((delta * count_mult + 0xffff) >> 16);
+    lapic.restartTimer(count ? count : 1);
+}
+
 bool Watch::prologue() {
-    return true;
+    int cpu = system.getCPUID();
+    uint64_t now = Clock::now_ns();
+
+    // the LAPIC timer and the TSC drift apart a little, so a slice that is
+    // almost over counts as over instead of costing another interrupt.
+    bool tick = now + (interval_ns >> 6) >= next_tick[cpu];
+    if (tick) {
+        next_tick[cpu] += interval_ns;
+        if (next_tick[cpu] <= now) { // missed some, e.g. while blocked
+            next_tick[cpu] = now + interval_ns;
+        }
+        ticked[cpu] = true;
+    }
+    bool hires = next_hires[cpu] <= now;
+
+    arm(now);
+    return tick || hires;
 }
 
 void Watch::epilogue() {
-    if (system.getCPUID() == 0) {
-        bellringer.check();
+    int cpu = system.getCPUID();
+
+    bellringer.check_hires(Clock::now_ns());
+    wakeup_at(bellringer.next_hires());
+
+    if (__atomic_exchange_n(&ticked[cpu], false, __ATOMIC_RELAXED)) {
+        if (cpu == 0) {
+            bellringer.check();
+        }
+        scheduler.resume();
     }
-    scheduler.resume();
+}
+
+void Watch::wakeup_at(uint64_t deadline) {
+    bool ints = CPU::disable_int();
+    next_hires[system.getCPUID()] = deadline;
+    arm(Clock::now_ns());
+    CPU::restore_int(ints);
 }
 
 uint32_t Watch::interval() {
@@ -47,7 +103,8 @@ uint32_t Watch::interval() {
 }
 
 void Watch::activate() {
-    lapic.setTimer(initial_count, divide, Plugbox::Vector::timer, true, false);
+    next_tick[system.getCPUID()] = Clock::now_ns() + interval_ns;
+    lapic.setTimer(initial_count, divide, Plugbox::Vector::timer, false, false);
 }
 
 void Watch::block() {
@@ -55,5 +112,9 @@ void Watch::block() {
 }
 
 void Watch::unblock() {
+    // a one-shot timer that ran out while masked does not fire anymore
+    bool ints = CPU::disable_int();
     lapic.setTimerMasked(false);
+    arm(Clock::now_ns());
+    CPU::restore_int(ints);
 }
@@ -10,12 +10,19 @@
 
 #include "types.h"
 #include "guard/gate.h"
+#include "machine/apicsystem.h"
 
 /*! \brief Interruptbehandlung für Timerinterrupts.
  *
  *  Die Klasse Watch sorgt für die Behandlung der Zeitgeberunterbrechungen,
  *  indem sie eine Zeitscheibe verwaltet und gegebenenfalls einen Threadwechsel
  *  auslöst.
+ *
+ *  Der LAPIC-Timer läuft im Einzelschussmodus: jede Unterbrechung stellt
+ *  ihn für den nächsten Zeitpunkt, an dem entweder die Zeitscheibe abläuft
+ *  (alle interval() Mikrosekunden) oder eine Glocke aus Bellringer::job_at()
+ *  auf dieser CPU läuten muss. Die Zeitpunkte werden mit Clock::now_ns()
+ *  gemessen, dadurch verschiebt sich der Takt durch das Neustellen nicht.
  */
 class Watch
 	: public Gate
@@ -28,8 +35,23 @@ class Watch
     uint32_t initial_count;
     uint8_t divide;
 
+    uint64_t interval_ns;
+    uint32_t count_mult;            // Timertakte pro ns, 16 Nachkommabits
+    uint64_t next_tick[CPU_MAX];    // Ende der Zeitscheibe
+    uint64_t next_hires[CPU_MAX];   // siehe wakeup_at()
+    bool ticked[CPU_MAX];           // Zeitscheibe abgelaufen, für epilogue()
+
+    // stellt den Timer der aktuellen CPU für den nächsten Zeitpunkt nach
+    // now; nur bei gesperrten Unterbrechungen aufrufen.
+    void arm(uint64_t now);
+
 public:
-	Watch() : irq_interval(0), initial_count(0), divide(0) {}
+	Watch() : irq_interval(0), initial_count(0), divide(0), interval_ns(0),
+	          count_mult(0), next_tick(), ticked() {
+		for (int i = 0; i < CPU_MAX; i++) {
+			next_hires[i] = ~0ULL;
+		}
+	}
 
 	/*! \brief Uhr "aufziehen"
 	 *
@@ -88,7 +110,18 @@ public:
 
     void block();
 
+    /*! \brief Gibt die Unterbrechungen wieder frei und stellt den Timer
+     *  neu, falls er abgelaufen ist, während sie blockiert waren.
+     */
     void unblock();
+
+    /*! \brief Die aktuelle CPU soll spätestens zum Zeitpunkt \b deadline
+     *  (in ns, siehe Clock::now_ns()) eine Unterbrechung bekommen.
+     *
+     *  Ersetzt den vorigen Zeitpunkt; wird von Bellringer auf Epilogebene
+     *  mit Bellringer::next_hires() aufgerufen.
+     */
+    void wakeup_at(uint64_t deadline);
 };
 
 extern Watch watch;
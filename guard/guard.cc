@@ -4,6 +4,7 @@
 #include "object/queue.h"
 #include "machine/ticketlock.h"
 #include "machine/cpu.h"
+#include "debug/trace.h"
 
 Guard guard;
 static Ticketlock bkl;
@@ -24,6 +25,7 @@ void Guard::leave() {
     while ((g = queue[system.getCPUID()].dequeue()) != 0) {
         g->set_dequeued();
         CPU::enable_int();
+        TRACE_EVENT(epilogue, g);
         g->epilogue();
         CPU::disable_int();
     }
@@ -44,6 +46,7 @@ void Guard::relay(Gate *item) {
         in_epilogue[id] = true;
         CPU::enable_int();
         bkl.lock();
+        TRACE_EVENT(epilogue, item);
         item->epilogue();
         leave();
     }
@@ -5,22 +5,25 @@
  */
 #include "types.h"
 #include "guardian.h"
-#include "debug/output.h"
+#include "debug/log.h"
 #include "machine/lapic.h"
 #include "machine/plugbox.h"
 #include "guard/guard.h"
+#include "debug/trace.h"
 
 extern "C" void guardian(uint32_t vector, irq_context *context) {
     (void) context;
+    TRACE_EVENT(irq_entry, vector);
     if (vector != Plugbox::Vector::timer && vector != Plugbox::Vector::rtc
             && vector != Plugbox::Vector::keyboard && vector != Plugbox::Vector::serial
             && vector != Plugbox::Vector::wakeup) {
-        DBG << "IRQ " << vector << endl;
+        LOG_WARN << "IRQ " << vector << endl;
     }
 
     Gate *g = plugbox.report(vector);
     bool req = g->prologue();
     lapic.ackIRQ();
+    TRACE_EVENT(irq_exit, vector);
     if (req) {
         guard.relay(g);
     }
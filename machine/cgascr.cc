@@ -4,15 +4,26 @@
 // Verwendung der Klasse IO_Port für Zugriff auf die Register
 #include "machine/io_port.h"
 #include "debug/output.h"
+#include "utils/memutil.h"
+#include "object/scrollback.h"
 
 static IO_Port index(0x3d4);
 static IO_Port data(0x3d5);
 
 CGA_Screen::Pixel * const CGA_Screen::CGA_BASE = (Pixel *) 0xb8000;
+// plain storage: a Pixel array would be initialized by a global constructor,
+// possibly after the first windows were already reset.
+static uint16_t shadow_buf[CGA_Screen::ROWS * CGA_Screen::COLUMNS];
+CGA_Screen::Pixel * const CGA_Screen::shadow = (Pixel *) shadow_buf;
 
-CGA_Screen::CGA_Screen(int from_col, int to_col, int from_row, int to_row, bool use_cursor) :
-    cur_x(from_col), cur_y(from_row), from_col(from_col), to_col(to_col), from_row(from_row),
-    to_row(to_row), height(to_row - from_row + 1), width(to_col - from_col + 1), use_cursor(use_cursor) {}
+// last position written to the CRTC, to skip redundant port accesses
+static int hw_cursor = -1;
+
+CGA_Screen::CGA_Screen(int from_col, int to_col, int from_row, int to_row, bool use_cursor,
+                       Scrollback *history) :
+    cur_x(from_col), cur_y(from_row), dirty(0), history(history), view(0), from_col(from_col), to_col(to_col),
+    from_row(from_row), to_row(to_row), height(to_row - from_row + 1),
+    width(to_col - from_col + 1), use_cursor(use_cursor) {}
 
 void CGA_Screen::setpos(int x, int y) {
     // account for negative x and y
@@ -29,47 +40,50 @@ void CGA_Screen::setpos(int x, int y) {
         return;
     }
 
+    cur_x = x;
+    cur_y = y;
+
 	if (use_cursor) {
 		int new_cursor = y * COLUMNS + x;
-		index.outb(15);
-		data.outb(new_cursor & 0xff);
-		index.outb(14);
-		data.outb((new_cursor >> 8) & 0xff);
-	} else {
-		cur_x = x;
-		cur_y = y;
+		if (new_cursor != hw_cursor) {
+			hw_cursor = new_cursor;
+			index.outb(15);
+			data.outb(new_cursor & 0xff);
+			index.outb(14);
+			data.outb((new_cursor >> 8) & 0xff);
+		}
 	}
 }
 
 void CGA_Screen::getpos(int& x, int& y) {
-	if (use_cursor) {
-		index.outb(15);
-		uint16_t cursor = data.inb();
-		index.outb(14);
-		cursor |= data.inb() << 8;
-
-		x = cursor % COLUMNS;
-		y = cursor / COLUMNS;
-        // sanity checks in case of unfortunate scheduling
-        if (x < from_col || x > to_col || y < from_row || y > to_row) {
-            DBG << "CGA_S: invalid getpos" << endl;
-            x = 0;
-            y = 0;
+    x = cur_x;
+    y = cur_y;
+}
+
+void CGA_Screen::sync() {
+    for (int y = from_row; y <= to_row; y++) {
+        if (dirty & (1u << y)) {
+            memcpy(&CGA_BASE[y * COLUMNS + from_col], &shadow[y * COLUMNS + from_col],
+                   width * sizeof(Pixel));
         }
-	} else {
-		x = cur_x;
-		y = cur_y;
-	}
+    }
+    dirty = 0;
 }
 
 void CGA_Screen::move_up_one_line(Attribute attrib) {
+    if (history) {
+        history->push(&shadow[from_row * COLUMNS + from_col], width);
+    }
+    for (int y = from_row; y <= to_row - 1; y++) {
+        memcpy(&shadow[y * COLUMNS + from_col], &shadow[(y + 1) * COLUMNS + from_col],
+               width * sizeof(Pixel));
+    }
+    // set last (new) row to nothing with correct Attribute
     for (int x = from_col; x <= to_col; x++) {
-		for (int y = from_row; y <= to_row - 1; y++) {
-		    CGA_BASE[y * COLUMNS + x] = CGA_BASE[(y + 1) * COLUMNS + x];
-        }
-        // set last (new) row to nothing with correct Attribute
-        CGA_BASE[to_row * COLUMNS + x] = {' ', attrib};
-	}
+        shadow[to_row * COLUMNS + x] = {' ', attrib};
+    }
+    // every row of the window has changed
+    dirty |= ((1u << height) - 1) << from_row;
 }
 
 void CGA_Screen::LF(int& x, int& y, Attribute attrib) {
@@ -80,7 +94,7 @@ void CGA_Screen::LF(int& x, int& y, Attribute attrib) {
     }
 }
 
-void CGA_Screen::print(char *string, int length, Attribute attrib) {
+void CGA_Screen::print(const char *string, int length, Attribute attrib) {
 	int x, y;
 	getpos(x, y);
     if (x < from_col || x > to_col || y < from_row || y > to_row) {
@@ -89,28 +103,88 @@ void CGA_Screen::print(char *string, int length, Attribute attrib) {
         return;
     }
 
+    // new output always shows the end of the window
+    if (view != 0) {
+        view = 0;
+        dirty |= ((1u << height) - 1) << from_row;
+    }
+
 	for (int i = 0; i < length; i++) {
 		if (string[i] == '\n') {
 			LF(x, y, attrib);
             continue;
 		}
 
-		show(x, y, string[i], attrib);
+		shadow[y * COLUMNS + x] = {string[i], attrib};
+		touch(y);
 		if (++x > to_col) {
             LF(x, y, attrib);
         }
 	}
 
+    sync();
     setpos(x, y);
 }
 
 void CGA_Screen::reset(char character, Attribute attrib) {
     setpos(from_col, from_row);
-	for (int x = from_col; x <= to_col; x++) {
-		for (int y = from_row; y <= to_row; y++) {
-			show(x, y, character, attrib);
+	for (int y = from_row; y <= to_row; y++) {
+		for (int x = from_col; x <= to_col; x++) {
+			shadow[y * COLUMNS + x] = {character, attrib};
 		}
+		touch(y);
 	}
+	sync();
+}
+
+void CGA_Screen::save(Pixel *buf) const {
+    for (int y = from_row; y <= to_row; y++) {
+        memcpy(&buf[(y - from_row) * width], &shadow[y * COLUMNS + from_col],
+               width * sizeof(Pixel));
+    }
+}
+
+void CGA_Screen::restore(const Pixel *buf) {
+    for (int y = from_row; y <= to_row; y++) {
+        memcpy(&shadow[y * COLUMNS + from_col], &buf[(y - from_row) * width],
+               width * sizeof(Pixel));
+        touch(y);
+    }
+    sync();
+}
+
+void CGA_Screen::scroll(int lines) {
+    if (!history) {
+        return;
+    }
+
+    int new_view = (int) view + lines;
+    if (new_view < 0) {
+        new_view = 0;
+    } else if (new_view > (int) history->lines()) {
+        new_view = history->lines();
+    }
+
+    if ((unsigned) new_view != view) {
+        view = new_view;
+        render();
+    }
+}
+
+void CGA_Screen::render() {
+    Pixel line[COLUMNS];
+    for (int r = 0; r < height; r++) {
+        int y = from_row + r;
+        const Pixel *src = line;
+        if (r < (int) view) {
+            history->get(view - r, line, width, Attribute());
+        } else {
+            src = &shadow[(y - (int) view) * COLUMNS + from_col];
+        }
+        memcpy(&CGA_BASE[y * COLUMNS + from_col], src, width * sizeof(Pixel));
+    }
+    // the shadow buffer is written back once the view returns to the end
+    dirty = 0;
 }
 
 void CGA_Screen::show(int x, int y, char character, Attribute attrib) {
@@ -128,5 +202,7 @@ void CGA_Screen::show(int x, int y, char character, Attribute attrib) {
         return;
     }
 
+    // a single cell is written through, there is nothing to batch
+    shadow[y * COLUMNS + x] = {character, attrib};
     CGA_BASE[y * COLUMNS + x] = {character, attrib};
 }
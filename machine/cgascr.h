@@ -8,6 +8,8 @@
 
 #include "types.h"
 
+class Scrollback;
+
 /*! \brief Abstraktion des CGA-Textmodus.
  *  \ingroup io
  *
@@ -21,6 +23,15 @@
  *  in seiner Position und Größe festgelegtem Fenster (mit eigenem Cursor).
  *  Dadurch ist es möglich die Ausgaben des Programms und etwaige Debugausgaben
  *  auf dem Bildschrim zu trennen, ohne synchronisieren zu müssen.
+ *
+ *  Alle Ausgaben gehen zunächst in einen Schattenpuffer im Hauptspeicher.
+ *  Jedes Fenster merkt sich die Zeilen, die es seitdem verändert hat, und
+ *  kopiert am Ende von print() nur diese (und nur seine eigenen Spalten) in
+ *  den Bildschirmspeicher. Die Cursorposition wird im Objekt gehalten; der
+ *  Hardwarecursor wird nur geschrieben, wenn sie sich ändert.
+ *
+ *  Optional werden die oben aus dem Fenster geschobenen Zeilen in einem
+ *  Scrollback gesammelt, durch den mit scroll() geblättert werden kann.
  */
 class CGA_Screen
 {
@@ -32,6 +43,29 @@ private:
     int cur_x;
 	int cur_y;
 
+	/// Bitmaske der seit dem letzten sync() veränderten Zeilen
+	uint32_t dirty;
+
+	/*! \brief Markiert die (absolute) Bildschirmzeile \p y als verändert.
+	 */
+	void touch(int y) {
+		dirty |= 1u << y;
+	}
+
+	/*! \brief Kopiert die veränderten Zeilen des Fensters in den Bildschirmspeicher.
+	 */
+	void sync();
+
+	/// Verlauf der aus dem Fenster geschobenen Zeilen (optional)
+	Scrollback *history;
+
+	/// Anzahl der Zeilen, um die die Anzeige zurückgeblättert ist
+	unsigned view;
+
+	/*! \brief Zeichnet das Fenster mit der zurückgeblätterten Anzeige neu.
+	 */
+	void render();
+
 public:
     const int from_col;
     const int to_col;
@@ -51,11 +85,13 @@ public:
 	 *  \param to_row Fensterrechteck erstreckt sich bis Zeile to_row (inklusive)
 	 *  \param use_cursor Gibt an, ob der CGA Hardwarecursor verwendet werden
 	 *  soll. Defaultmässig ist dies nicht der Fall.
+	 *  \param history Scrollback für die herausgeschobenen Zeilen (optional)
 	 *
 	 *  \todo Konstruktor implementieren
 	 *
 	 */
-	CGA_Screen(int from_col, int to_col, int from_row, int to_row, bool use_cursor = false);
+	CGA_Screen(int from_col, int to_col, int from_row, int to_row, bool use_cursor = false,
+	           Scrollback *history = nullptr);
 
 	/// Groesse des kompletten CGA-Bildschirms
 	static const int ROWS = 25;    // 25 Zeilen
@@ -117,6 +153,12 @@ public:
 
     static Pixel * const CGA_BASE;
 
+private:
+	/// Schattenpuffer des kompletten Bildschirms
+	static Pixel * const shadow;
+
+public:
+
 	/*! \brief Setzen des Cursors im Fenster auf Spalte \p x und Zeile \p y.
 	 *
 	 *  Abhängig vom Konstruktorparameter \c use_cursor wird hier entweder der
@@ -193,7 +235,7 @@ public:
 	 *  \param length Länge der Zeichenkette
 	 *  \param attrib Farbattribut zur Darstellung
 	 */
-	void print(char* string, int length, Attribute attrib = Attribute());
+	void print(const char* string, int length, Attribute attrib = Attribute());
 
 	/*! \brief Löschen des Inhalts und Zurücksetzen des Cursors
 	 *
@@ -204,6 +246,27 @@ public:
 	 */
 	void reset(char character=' ', Attribute attrib = Attribute());
 
+	/*! \brief Sichert den Inhalt des Fensters.
+	 *
+	 *  \param buf Puffer für width * height Zeichen
+	 */
+	void save(Pixel *buf) const;
+
+	/*! \brief Stellt einen mit save() gesicherten Inhalt des Fensters wieder her.
+	 *
+	 *  \param buf Puffer mit width * height Zeichen
+	 */
+	void restore(const Pixel *buf);
+
+	/*! \brief Blättert die Anzeige im Scrollback.
+	 *
+	 *  Die nächste Ausgabe springt wieder an das Ende zurück.
+	 *
+	 *  \param lines Anzahl der Zeilen, positiv zurück in den Verlauf,
+	 *  negativ wieder Richtung Ende
+	 */
+	void scroll(int lines);
+
 	/*! \brief Grundlegende Anzeige eines Zeichens mit Attribut an einer bestimmten
 	 * Stelle auf dem kompletten CGA-Bildschirm.
 	 *
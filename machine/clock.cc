@@ -0,0 +1,74 @@
+// vim: set et ts=4 sw=4:
+
+#include "machine/clock.h"
+#include "machine/io_port.h"
+#include "debug/output.h"
+#include "utils/math.h"
+
+uint64_t Clock::base     = 0;
+uint64_t Clock::hz       = 0;
+uint32_t Clock::mult     = 0;
+uint32_t Clock::shift    = 32;
+bool     Clock::constant = false;
+
+// input clock of the PIT
+static const uint32_t PIT_HZ = 1193182;
+static const uint32_t PIT_COUNT = 0xffff;
+
+// Counts the TSC cycles while PIT channel 2 counts down once from PIT_COUNT
+// (54.9 ms), like LAPIC::timer_ticks().
+static uint64_t measure() {
+    IO_Port ctrl(0x43);
+    IO_Port data(0x42);
+    IO_Port help(0x61);
+
+    // speaker disable, timer gate enable
+    help.outb(0x01);
+    // channel 2, low and high byte, mode 0 (interrupt on terminal count)
+    ctrl.outb(0xB0);
+    data.outb(PIT_COUNT & 0xff);
+    data.outb(PIT_COUNT >> 8);
+
+    uint64_t start = CPU::rdtsc();
+    while (!(help.inb() & 0x20)) ;
+    return CPU::rdtsc() - start;
+}
+
+static bool has_invariant_tsc() {
+    uint32_t regs[4];
+    CPU::cpuid(0x80000000, regs);
+    if (regs[0] < 0x80000007) {
+        return false;
+    }
+    CPU::cpuid(0x80000007, regs);
+    return regs[3] & (1 << 8);
+}
+
+void Clock::calibrate() {
+    constant = has_invariant_tsc();
+    hz = Math::div64(measure() * PIT_HZ, PIT_COUNT);
+    if (hz == 0) {
+        DBG << "Clock: TSC does not count, now_ns() stays 0" << endl;
+        return;
+    }
+
+    // the largest shift whose factor still fits into 32 bits gives the most
+    // precision; with hz > 1e9 / 2^32 (0.23 Hz) there is always one.
+    const uint64_t ns_per_s = 1000000000;
+    uint64_t m;
+    for (shift = 32; ; shift--) {
+        m = Math::div64(ns_per_s << shift, hz);
+        if (m >> 32 == 0 || shift == 0) {
+            break;
+        }
+    }
+    mult = (uint32_t) m;
+    base = CPU::rdtsc();
+
+    DBG << "Clock: TSC at " << tsc_khz() << " kHz"
+        << (constant ? "" : " (not invariant, times may differ across CPUs)") << endl;
+}
+
+uint32_t Clock::tsc_khz() {
+    return (uint32_t) Math::div64(hz, 1000);
+}
@@ -0,0 +1,79 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Clock.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "machine/cpu.h"
+
+/*! \brief Monotonic high-resolution time, based on the time stamp counter.
+ *
+ *  calibrate() measures the TSC frequency once at boot against the PIT and
+ *  derives a fixed-point factor, so that converting cycles into nanoseconds
+ *  takes two multiplications and no division:
+ *
+ *      ns = (cycles * mult) >> shift
+ *
+ *  Afterwards, the values never change. now_ns() only reads them and the
+ *  TSC of the current CPU, so it can be called on every CPU, in prologues
+ *  and with interrupts disabled, without any lock.
+ *
+ *  The times of different CPUs are only comparable if the TSC is invariant
+ *  (it runs at a constant rate in all power states, see invariant()), as
+ *  the TSCs of all CPUs start at the same reset and then stay in step.
+ *  calibrate() logs a warning if it is not.
+ */
+class Clock {
+    // Disallow copies and assignments.
+    Clock(const Clock&)            = delete;
+    Clock& operator=(const Clock&) = delete;
+
+    static uint64_t base;       // TSC at calibration, i.e. now_ns() == 0
+    static uint64_t hz;
+    static uint32_t mult;
+    static uint32_t shift;
+    static bool constant;
+
+public:
+    /*! \brief Measures the TSC frequency and checks for an invariant TSC.
+     *
+     *  Must be called once on the boot CPU before the other CPUs are
+     *  started and before interrupts are enabled. Takes about 55 ms.
+     */
+    static void calibrate();
+
+    /*! \brief Converts a number of TSC cycles into nanoseconds.
+     */
+    static uint64_t cycles_to_ns(uint64_t cycles) {
+        // 64 x 32 bit multiplication, split in halves to stay in 64 bits
+        uint64_t lo = (uint64_t) (uint32_t) cycles * mult;
+        uint64_t hi = (uint64_t) (uint32_t) (cycles >> 32) * mult;
+        return (lo >> shift) + (hi << (32 - shift));
+    }
+
+    /*! \brief Nanoseconds since calibrate(); 0 before.
+     */
+    static uint64_t now_ns() {
+        return cycles_to_ns(CPU::rdtsc() - base);
+    }
+
+    /*! \brief TSC frequency in Hz (0 before calibrate()).
+     */
+    static uint64_t tsc_hz() {
+        return hz;
+    }
+
+    /*! \brief TSC frequency in kHz, e.g. for printing.
+     */
+    static uint32_t tsc_khz();
+
+    /*! \brief true if the CPU reports an invariant TSC (CPUID 0x80000007,
+     *  EDX bit 8).
+     */
+    static bool invariant() {
+        return constant;
+    }
+};
@@ -123,6 +123,25 @@ public:
 	static void wrmsr(uint32_t id, uint64_t val) {
 		asm volatile("wrmsr" : : "A"(val), "c"(id) : "memory");
 	}
+
+	/*! \brief Liest den Time Stamp Counter der aktuellen CPU.
+	 *  \return Anzahl der Takte seit dem Reset
+	 */
+	static uint64_t rdtsc() {
+		uint64_t tsc;
+		asm volatile("rdtsc" : "=A"(tsc));
+		return tsc;
+	}
+
+	/*! \brief Führt die Instruktion \c cpuid für \b leaf aus.
+	 *  \param leaf Abgefragte Funktion (Wert in \c eax)
+	 *  \param regs Ergebnis in der Reihenfolge \c eax, \c ebx, \c ecx, \c edx
+	 */
+	static void cpuid(uint32_t leaf, uint32_t regs[4]) {
+		asm volatile("cpuid"
+		             : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+		             : "a"(leaf), "c"(0));
+	}
 };
 
 /*! \brief Gesicherter Unterbrechungskontext (generischer Teil)
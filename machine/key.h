@@ -202,7 +202,7 @@ public:
 	struct scan {
 		enum {
 			f1 = 0x3b, del = 0x53, up=72, down=80, left=75, right=77,
-			div = 8
+			pgup = 73, pgdn = 81, div = 8
 		};
 	};
 };
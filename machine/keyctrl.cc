@@ -4,6 +4,7 @@
 
 #include "machine/keyctrl.h"
 #include "debug/output.h"
+#include "debug/log.h"
 
 /* GLOBALE VARIABLEN */
 
@@ -35,7 +36,7 @@ Key Keyboard_Controller::key_hit() {
         uint8_t code = data_port.inb();
 
         if (control_status & auxb) {
-            DBG << "KB_C: lol mouse " << flush;
+            LOG_DEBUG << "KB_C: lol mouse" << endl;
             continue;
         }
 
@@ -145,6 +145,12 @@ bool LAPIC::isPentium4orNewer()
 
 uint32_t LAPIC::timer_ticks()
 {
+	// all LAPIC timers run at the bus clock, so measuring once is enough
+	static uint32_t freq = 0;
+	if (freq != 0) {
+		return freq;
+	}
+
 	// PIT ports
 	IO_Port ctrl(0x43);
 	IO_Port data(0x42);
@@ -172,7 +178,7 @@ uint32_t LAPIC::timer_ticks()
 	// disable LAPIC timer, single shot, no IRQs
 	setTimer(0, 1, 42, false, true);
 
-	uint32_t freq = (uint32_t)Math::div64(((uint64_t) ticks) * 1000 * 1000, 838 * 65535);
+	freq = (uint32_t)Math::div64(((uint64_t) ticks) * 1000 * 1000, 838 * 65535);
 	return freq;
 }
 
@@ -224,6 +230,11 @@ void LAPIC::setTimer(uint32_t counter, uint8_t divide, uint8_t vector, bool peri
     write(icr_reg, lr);
 }
 
+void LAPIC::restartTimer(uint32_t counter) {
+    LAPICRegister_t lr = { .value = counter };
+    write(icr_reg, lr);
+}
+
 void LAPIC::setTimerMasked(bool masked) {
     LAPICRegister_t lr = read(timerctrl_reg);
     lr.timer_ctrl.masked = masked;
@@ -125,6 +125,9 @@ public:
 	 */
 	bool isPentium4orNewer();
 	/*! \brief Ermittelt die Frequenz des LAPIC-Timers.
+	 *
+	 *  Die Messung gegen den PIT dauert ca. 55 ms und wird nur beim ersten
+	 *  Aufruf durchgeführt, danach wird das Ergebnis wiederverwendet.
 	 *  \return Anzahl der Timerticks pro Millisekunde
 	 *
 	 */
@@ -145,6 +148,14 @@ public:
 	void setTimer(uint32_t counter, uint8_t divide, uint8_t vector, bool periodic, bool masked = false);
 
     void setTimerMasked(bool masked = false);
+
+	/*! \brief Startet den mit setTimer() eingestellten Timer mit dem
+	 *  Startwert \b counter neu.
+	 *
+	 *  Im Einzelschussmodus wird damit die nächste Unterbrechung nach
+	 *  \b counter Takten ausgelöst, ohne Modus und Teiler neu zu schreiben.
+	 */
+	void restartTimer(uint32_t counter);
 };
 
 // global object declaration
@@ -0,0 +1,69 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Seqlock.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "machine/spinlock.h"
+
+/*! \brief Sequence lock for small, read-mostly data: readers on any CPU
+ *  never write shared memory and never block a writer.
+ *
+ *  A writer makes the sequence number odd, changes the data and makes it
+ *  even again. A reader copies the data and then checks whether the number
+ *  is still the same, even one. If it is not, the copy may be torn and the
+ *  reader tries again:
+ *
+ *      Time t;
+ *      unsigned seq;
+ *      do {
+ *          seq = lock.read_begin();
+ *          t = shared;
+ *      } while (lock.read_retry(seq));
+ *
+ *  Writers exclude each other with a spinlock. A writer that can be
+ *  interrupted by another writer or reader on the same CPU (e.g. in a
+ *  prologue) must disable interrupts first.
+ */
+class Seqlock {
+    // Disallow copies and assignments.
+    Seqlock(const Seqlock&)            = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    unsigned int seq;
+    Spinlock writers;
+
+public:
+    Seqlock() : seq(0) {}
+
+    //! \brief Waits until no writer is active and returns the number to
+    //! pass to read_retry().
+    unsigned int read_begin() const {
+        unsigned int s;
+        while ((s = __atomic_load_n(&seq, __ATOMIC_ACQUIRE)) & 1) ;
+        return s;
+    }
+
+    //! \brief true if a writer has been active since read_begin(), i.e. the
+    //! data read in between may be inconsistent.
+    bool read_retry(unsigned int start) const {
+        // the data loads must not move after this check
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return __atomic_load_n(&seq, __ATOMIC_RELAXED) != start;
+    }
+
+    void write_lock() {
+        writers.lock();
+        __atomic_store_n(&seq, seq + 1, __ATOMIC_RELAXED);
+        // the data stores must not move before the odd number
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    void write_unlock() {
+        __atomic_store_n(&seq, seq + 1, __ATOMIC_RELEASE);
+        writers.unlock();
+    }
+};
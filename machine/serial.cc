@@ -17,6 +17,9 @@ Serial::Serial(Serial::comPort port, Serial::baudRate baudrate, Serial::dataBits
     /// databits + stopbits + parity
     writeReg(lcr, databits | stopbits | parity);
 
+    // enable and clear both FIFOs, receive interrupt at 14 bytes (or timeout)
+    writeReg(fcr, 0xc7);
+
     // disable interrupts for normal reading
     writeReg(ier, 0x00);
     //DBG << "serial: finished init" << endl;
@@ -48,6 +51,24 @@ int Serial::write(char out, bool blocking) {
 	return out;
 }
 
+size_t Serial::write(const char *buf, size_t len, bool blocking) {
+    size_t written = 0;
+    while (written < len) {
+        if (!canWrite()) {
+            if (!blocking) {
+                break;
+            }
+            while (!canWrite()) ;
+        }
+
+        // the transmit FIFO is empty, so it can take a whole burst
+        for (unsigned i = 0; i < FIFO_SIZE && written < len; i++) {
+            writeFifo(buf[written++]);
+        }
+    }
+    return written;
+}
+
 int Serial::read(bool blocking) {
     if (!blocking) {
         if (readReg(lsr) & 1) {
@@ -63,8 +84,9 @@ int Serial::read(bool blocking) {
 
 bool Serial::receiveInterrupt(bool enable) {
     // enable interrupt when data is available
-    bool old = readReg(ier) & 0x01;
-    writeReg(ier, enable ? 0x01 : 0x00);
+    uint8_t old_ier = readReg(ier);
+    bool old = old_ier & 0x01;
+    writeReg(ier, enable ? (old_ier | 0x01) : (old_ier & ~0x01));
     // weird stuff, idk
     writeReg(mcr, 0x0b);
 
@@ -79,7 +101,7 @@ bool Serial::receiveInterrupt(bool enable) {
     }
     if (enable) {
         ioapic.allow(system.getIOAPICSlot(dev));
-    } else {
+    } else if (!(old_ier & 0x02)) { // keep transmit interrupts working
         ioapic.forbid(system.getIOAPICSlot(dev));
     }
 
@@ -88,3 +110,9 @@ bool Serial::receiveInterrupt(bool enable) {
 
     return old;
 }
+
+bool Serial::transmitInterrupt(bool enable) {
+    uint8_t old_ier = readReg(ier);
+    writeReg(ier, enable ? (old_ier | 0x02) : (old_ier & ~0x02));
+    return old_ier & 0x02;
+}
@@ -115,7 +115,45 @@ private:
 	 */
 	void writeReg(Serial::regIndex reg, uint8_t out);
 
+protected:
+	/*! \brief Quelle einer Unterbrechung (Bits 1-3 des Interrupt Identification Registers) */
+	enum interruptId {
+		IID_NONE = 0x01,    // bit 0 set: no interrupt pending
+		IID_MODEM = 0x00,
+		IID_TX_EMPTY = 0x02,
+		IID_RX_DATA = 0x04,
+		IID_LINE = 0x06,
+		IID_RX_TIMEOUT = 0x0c,
+	};
+
+	/*! \brief Liest die Quelle der anstehenden Unterbrechung aus.
+	 *
+	 *  Das Auslesen quittiert eine Unterbrechung durch einen leeren Sendepuffer.
+	 */
+	interruptId pendingInterrupt() {
+		return (interruptId) (readReg(irr) & 0x0f);
+	}
+
+	/*! \brief Liest das Line Status Register, wodurch auch eine
+	 *  Unterbrechung aufgrund eines Übertragungsfehlers quittiert wird.
+	 */
+	uint8_t lineStatus() {
+		return readReg(lsr);
+	}
+
+	/*! \brief Schreibt ein Byte ohne Prüfung in den Sende-FIFO.
+	 *
+	 *  Nachdem canWrite() einen leeren FIFO gemeldet hat, dürfen so bis zu
+	 *  FIFO_SIZE Bytes geschrieben werden.
+	 */
+	void writeFifo(char out) {
+		writeReg(tbr, out);
+	}
+
 public:
+	/*! \brief Größe des Sende- und des Empfangs-FIFOs des 16550 */
+	static const unsigned FIFO_SIZE = 16;
+
 	/*! \brief Konstruktor
 	 *
 	 * Festlegen des Ports und setzen der Parameter für die serielle Verbindung
@@ -145,6 +183,35 @@ public:
 	 */
 	int write(char out, bool blocking = true);
 
+	/*! \brief Schreibe mehrere Bytes auf die serielle Schnittstelle
+	 *
+	 *  Sobald der Sendepuffer leer ist, werden bis zu FIFO_SIZE Bytes am Stück
+	 *  in den FIFO geschrieben, statt vor jedem Byte erneut zu warten.
+	 *
+	 *  \param buf zu schreibende Bytes
+	 *  \param len Anzahl der Bytes
+	 *  \param blocking Blockiere - Warte bis alle Bytes geschrieben werden konnten
+	 *  \return Anzahl der geschriebenen Bytes
+	 */
+	size_t write(const char *buf, size_t len, bool blocking = true);
+
+	/*! \brief Prüft, ob der Sende-FIFO leer ist und FIFO_SIZE Bytes
+	 *  aufnehmen kann.
+	 */
+	bool canWrite() {
+		return readReg(lsr) & (1 << 5);
+	}
+
     bool receiveInterrupt(bool enable);
+
+	/*! \brief Unterbrechung bei leerem Sende-FIFO (de)aktivieren.
+	 *
+	 *  Beim Aktivieren löst der 16550 sofort eine Unterbrechung aus, falls der
+	 *  Sende-FIFO bereits leer ist.
+	 *
+	 *  \param enable Unterbrechung aktivieren
+	 *  \return vorheriger Zustand
+	 */
+	bool transmitInterrupt(bool enable);
 };
 
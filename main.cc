@@ -10,12 +10,16 @@
 #include "machine/keyctrl.h"
 #include "machine/ioapic.h"
 #include "machine/cpu.h"
+#include "machine/clock.h"
 #include "syscall/guarded_scheduler.h"
 #include "syscall/guarded_keyboard.h"
 #include "thread/scheduler.h"
 #include "thread/assassin.h"
 #include "thread/idlethread.h"
+#include "thread/logthread.h"
 #include "thread/wakeup.h"
+#include "thread/workqueue.h"
+#include "thread/task.h"
 #include "user/app1/appl.h"
 #include "user/app2/kappl.h"
 #include "user/status/sappl.h"
@@ -28,6 +32,9 @@ static unsigned char cpu_stack[(CPU_MAX - 1) * CPU_STACK_SIZE];
 
 Thread *victim; // to test scheduler.kill() in user/app2
 
+// the ClockApplication kills the victim, then joins and deletes it
+#define CLOCK_APPLICATION 0
+
 extern "C" int main() {
     // print starting stuff
     APICSystem::SystemType type = system.getSystemType();
@@ -45,6 +52,7 @@ extern "C" int main() {
     GDB_Stub gdb; // must be before console.listen (or IRQs are disabled)
     console.listen();
     rtc.init();
+    Clock::calibrate();
     watch.windup(1000); // 1 irq per ms
     wakeup.activate();
     assassin.hire();
@@ -55,29 +63,46 @@ extern "C" int main() {
         scheduler.set_idle_thread(i, idle);
     }
 
+    // set up the thread printing the kernel log
+    Guarded_Scheduler::ready(new LogThread);
+
+    // set up the workers for the deferred work of interrupt handlers
+    workqueue.start();
+    ordered_workqueue.start();
+
+    // set up the executors for stackless tasks
+    Executor::start();
+
     // set up normal applications
     int i = 0;
 #if 1
     for (; i < 10; i++) {
         Application *a = new Application(i);
-        Guarded_Scheduler::ready(a);
         if (i == 0) {
             victim = a;
         }
+        // deleted once they are done, but the ClockApplication deletes the
+        // victim itself.
+        if (i != 0 || !CLOCK_APPLICATION) {
+            Guarded_Scheduler::detach(a);
+        }
+        Guarded_Scheduler::ready(a);
     }
 #endif
 
     // set up special applications
     KeyboardApplication *a_kb = new KeyboardApplication(i++);
+    Guarded_Scheduler::detach(a_kb);
     Guarded_Scheduler::ready(a_kb);
 
 #if 1
     StatusApplication *a_st = new StatusApplication(i++);
-    Guarded_Scheduler::ready(a_st);
+    a_st->start();
 #endif
 
-#if 0
+#if CLOCK_APPLICATION
     ClockApplication *a_cl = new ClockApplication(i++);
+    Guarded_Scheduler::detach(a_cl);
     Guarded_Scheduler::ready(a_cl);
 #endif
 
@@ -0,0 +1,18 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/barrier.h"
+#include "thread/scheduler.h"
+
+bool Barrier::wait() {
+    if (++arrived < count) {
+        scheduler.block(this);
+        return false;
+    }
+
+    arrived = 0;
+    Thread *t;
+    while ((t = dequeue()) != nullptr) {
+        scheduler.wakeup(t);
+    }
+    return true;
+}
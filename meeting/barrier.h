@@ -0,0 +1,39 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Barrier.
+ */
+
+#pragma once
+
+#include "meeting/waitingroom.h"
+
+/*! \brief Blocks a group of threads until all of them have arrived.
+ *  \ingroup ipc
+ *
+ *  The barrier is set up for a fixed number of threads, which may run on
+ *  different CPUs. The last one to arrive wakes all others and resets the
+ *  barrier, so it can be used again for the next round right away.
+ *
+ *  All methods must be called at epilogue level (see Guarded_Barrier).
+ */
+class Barrier : public Waitingroom {
+    // Disallow copies and assignments.
+    Barrier(const Barrier&)            = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    const unsigned int count;
+    unsigned int arrived;
+
+public:
+    /*! \param count Number of threads that have to arrive, at least 1
+     */
+    explicit Barrier(unsigned int count) : count(count), arrived(0) {}
+
+    /*! \brief Waits until \c count threads (including this one) have called
+     *  wait().
+     *  \return true for exactly one thread of each round, the last one to
+     *          arrive
+     */
+    bool wait();
+};
@@ -2,10 +2,13 @@
 
 #include "meeting/bell.h"
 #include "meeting/bellringer.h"
+#include "machine/clock.h"
 #include "thread/scheduler.h"
 #include "debug/output.h"
+#include "debug/trace.h"
 
 void Bell::ring() {
+    TRACE_EVENT(bell_fire, this);
     Thread *t;
     // this also considers the possibility that no thread was in the queue,
     // which might happen if the only thread in the queue was killed.
@@ -14,6 +17,13 @@ void Bell::ring() {
     }
 }
 
+void Bell::remove(Thread *customer) {
+    Waitingroom::remove(customer);
+    if (first() == nullptr) {
+        bellringer.cancel(this);
+    }
+}
+
 void Bell::sleep(unsigned int ms) {
     if (ms == 0) {
         return;
@@ -23,3 +33,18 @@ void Bell::sleep(unsigned int ms) {
     bellringer.job(&bell, ms);
     scheduler.block(&bell);
 }
+
+void Bell::sleep_until(uint64_t deadline, uint32_t slack) {
+    if (deadline <= Clock::now_ns()) {
+        return;
+    }
+
+    Bell bell;
+    bellringer.job_at(&bell, deadline, slack);
+    scheduler.block(&bell);
+}
+
+void Bell::sleep_us(unsigned int us) {
+    uint64_t ns = (uint64_t) us * 1000;
+    sleep_until(Clock::now_ns() + ns, slack_for(ns));
+}
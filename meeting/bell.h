@@ -6,8 +6,9 @@
  *  \brief Enthält die Klasse Bell.
  */
 
+#include "types.h"
 #include "meeting/waitingroom.h"
-#include "object/queuelink.h"
+#include "object/list.h"
 class Bellringer;
 
 /*! \brief Synchronisationsobjekt zum Schlafenlegen für eine bestimmte
@@ -32,7 +33,14 @@ private:
 	friend class Bellringer;
 
     unsigned int ms;
-    QueueLink<Bell> bellringer_link;
+    ListLink<Bell> bellringer_link;
+
+    // für Bellringer::job_at(): Weckzeitpunkt in ns (siehe Clock::now_ns()),
+    // erlaubte Verspätung in ns und die CPU, in deren Liste die Glocke hängt
+    // (-1: in der Millisekunden-Liste oder in gar keiner)
+    uint64_t deadline;
+    uint32_t slack;
+    int cpu;
 
 public:
 	/*! \brief Konstruktor.
@@ -42,17 +50,37 @@ public:
 	 *  \todo Konstruktor implementieren
 	 *
 	 */
-	Bell() : ms(0) {}
+	Bell() : ms(0), deadline(0), slack(0), cpu(-1) {}
+
+	/*! \brief Wartezeiten unterhalb dieser Grenze (in ns) wartet
+	 *  Guarded_Bell aktiv ab, weil Blockieren, Unterbrechung und
+	 *  Threadwechsel länger dauern würden.
+	 */
+	static const uint32_t SPIN_NS = 10000;
+
+	/*! \brief Höchste Verspätung (in ns), die sleep_us() einem Wecker
+	 *  erlaubt, damit nahe beieinander liegende Wecker mit einer
+	 *  Unterbrechung auskommen.
+	 */
+	static const uint32_t MAX_SLACK_NS = 50000;
 
 	/*! \brief Läuten der Glocke
 	 *
 	 *  Wird von Bellringer aufgerufen, wenn die Wartezeit abgelaufen ist und
-	 *  weckt den schlafenden Thread.
+	 *  weckt den schlafenden Thread. Abgeleitete Klassen (z.B. Timeout)
+	 *  können stattdessen etwas anderes tun.
 	 *
-	 *  \todo Methode implementieren
+	 */
+	virtual void ring();
+
+	/*! \brief Nimmt \p customer aus dem Wecker; war er der letzte
+	 *  Schläfer, wird auch der Wecker beim Glöckner abgemeldet.
 	 *
+	 *  So bleibt ein Wecker auf dem Stack eines Threads, der im Schlaf
+	 *  getötet wird, nicht beim Glöckner zurück, wenn der Stack freigegeben
+	 *  wird.
 	 */
-	void ring();
+	void remove(Thread *customer) override;
 
 	/*! \brief Temporäres Bell-Objekt erzeugen und Thread schlafen legen, bis
 	 * der Wecker klingelt.
@@ -63,5 +91,31 @@ public:
 	 *
 	 */
 	static void sleep(unsigned int ms);
+
+	/*! \brief Legt den Thread bis zum Zeitpunkt \b deadline schlafen.
+	 *
+	 *  Anders als sleep() ist die Auflösung nicht an den Takt von Watch
+	 *  gebunden: der Wecker kommt in eine Liste der aktuellen CPU, deren
+	 *  LAPIC-Timer für den frühesten Zeitpunkt programmiert wird (siehe
+	 *  Bellringer::job_at()).
+	 *  \param deadline Zeitpunkt in ns, gemessen mit Clock::now_ns(). Liegt er
+	 *  nicht in der Zukunft, kehrt die Methode sofort zurück.
+	 *  \param slack So viele ns darf der Thread später geweckt werden, damit
+	 *  die Unterbrechung auch für andere Wecker genutzt werden kann.
+	 */
+	static void sleep_until(uint64_t deadline, uint32_t slack = 0);
+
+	/*! \brief Legt den Thread für \b us Mikrosekunden schlafen.
+	 *
+	 *  Erlaubt eine Verspätung von einem Sechzehntel der Wartezeit, höchstens
+	 *  aber MAX_SLACK_NS.
+	 */
+	static void sleep_us(unsigned int us);
+
+	/*! \brief Die erlaubte Verspätung für eine Wartezeit von \b ns.
+	 */
+	static uint32_t slack_for(uint64_t ns) {
+		return ns / 16 < MAX_SLACK_NS ? ns / 16 : MAX_SLACK_NS;
+	}
 };
 
@@ -2,6 +2,7 @@
 
 #include "meeting/bellringer.h"
 #include "debug/output.h"
+#include "device/watch.h"
 
 Bellringer bellringer;
 
@@ -41,6 +42,17 @@ void Bellringer::job(Bell *bell, unsigned int ms) {
 }
 
 void Bellringer::cancel(Bell *bell) {
+    if (bell->cpu >= 0) {
+        // the timer of that CPU may still go off for this bell, which does
+        // no harm.
+        hires_list[bell->cpu].remove(bell);
+        bell->cpu = -1;
+        return;
+    }
+
+    if (!bell_list.contains(bell)) {
+        return;
+    }
     Bell *next = bell_list.next(bell);
     if (next) {
         next->ms += bell->ms;
@@ -51,3 +63,54 @@ void Bellringer::cancel(Bell *bell) {
 bool Bellringer::bell_pending() {
     return bell_list.first() != nullptr;
 }
+
+void Bellringer::job_at(Bell *bell, uint64_t deadline, uint32_t slack) {
+    int cpu = system.getCPUID();
+    bell->deadline = deadline;
+    bell->slack = slack;
+    bell->cpu = cpu;
+
+    Bell *prev = nullptr;
+    for (Bell *b : hires_list[cpu]) {
+        if (b->deadline > deadline) {
+            break;
+        }
+        prev = b;
+    }
+    if (prev == nullptr) {
+        hires_list[cpu].insert_first(bell);
+    } else {
+        hires_list[cpu].insert_after(prev, bell);
+    }
+
+    watch.wakeup_at(next_hires());
+}
+
+void Bellringer::check_hires(uint64_t now) {
+    List<Bell, &Bell::bellringer_link> &list = hires_list[system.getCPUID()];
+    Bell *first;
+    while ((first = list.first()) && first->deadline <= now) {
+        list.dequeue();
+        first->cpu = -1;
+        first->ring();
+    }
+}
+
+uint64_t Bellringer::next_hires() {
+    // the list is sorted by deadline, so only bells before the best time so
+    // far can still have an earlier deadline + slack.
+    uint64_t next = ~0ULL;
+    for (Bell *b : hires_list[system.getCPUID()]) {
+        if (b->deadline >= next) {
+            break;
+        }
+        if (b->deadline + b->slack < next) {
+            next = b->deadline + b->slack;
+        }
+    }
+    return next;
+}
+
+bool Bellringer::hires_pending() {
+    return hires_list[system.getCPUID()].first() != nullptr;
+}
@@ -7,7 +7,8 @@
 #pragma once
 
 #include "meeting/bell.h"
-#include "object/queue.h"
+#include "object/list.h"
+#include "machine/apicsystem.h"
 /*! \brief Verwaltung und Anstoßen von zeitgesteuerten Aktivitäten.
  *  \ingroup ipc
  *
@@ -20,6 +21,12 @@
  *
  *  Auf diese Weise erreicht man eine Komplexität vom O(1) im Timer
  *  Interrupt, sofern keine Glocke aktiviert werden muss.
+ *
+ *  Glocken mit einem Zeitpunkt in Nanosekunden (job_at()) verwaltet der
+ *  Glöckner dagegen in je einer nach Zeitpunkt sortierten Liste pro CPU.
+ *  Watch programmiert den LAPIC-Timer dieser CPU für den Zeitpunkt, an dem
+ *  die erste davon spätestens läuten muss (next_hires()), und ruft dann
+ *  check_hires() auf.
  */
 class Bellringer
 {
@@ -28,7 +35,8 @@ class Bellringer
 	Bellringer& operator=(const Bellringer&) = delete;
 
 private:
-    Queue<Bell, &Bell::bellringer_link> bell_list;
+    List<Bell, &Bell::bellringer_link> bell_list;
+    List<Bell, &Bell::bellringer_link> hires_list[CPU_MAX];
 
 public:
 	/*! \brief Konstruktor.
@@ -75,6 +83,31 @@ public:
 	 */
 	bool bell_pending();
 
+	/*! \brief Die Glocke \b bell soll zum Zeitpunkt \b deadline geläutet
+	 *  werden, spätestens aber \b slack ns danach.
+	 *
+	 *  Die Glocke kommt in die Liste der aktuellen CPU. Deren Timer wird
+	 *  gegebenenfalls früher gestellt (Watch::wakeup_at()). Eine Glocke wird
+	 *  nie vor \b deadline geläutet; alle Glocken, deren Zeitpunkt bei einer
+	 *  Unterbrechung erreicht ist, läuten gemeinsam.
+	 *  \param deadline Zeitpunkt in ns, gemessen mit Clock::now_ns().
+	 */
+	void job_at(Bell *bell, uint64_t deadline, uint32_t slack);
+
+	/*! \brief Läutet alle Glocken der aktuellen CPU, deren Zeitpunkt
+	 *  \b now erreicht hat.
+	 */
+	void check_hires(uint64_t now);
+
+	/*! \brief Spätester Zeitpunkt, zu dem auf der aktuellen CPU die nächste
+	 *  Glocke läuten muss, oder \c ~0, falls keine eingehangen ist.
+	 */
+	uint64_t next_hires();
+
+	/*! \brief Ist auf der aktuellen CPU eine Glocke mit Zeitpunkt
+	 *  eingehangen?
+	 */
+	bool hires_pending();
 };
 
 extern Bellringer bellringer;
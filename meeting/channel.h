@@ -0,0 +1,208 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class template Channel.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "meeting/waitingroom.h"
+#include "meeting/timeout.h"
+#include "thread/scheduler.h"
+
+/*! \brief Typed message queue between threads, holding up to \p N messages.
+ *  \ingroup ipc
+ *
+ *  send() blocks while the channel is full and recv() while it is empty.
+ *  If a receiver is already waiting, send() copies the message straight into
+ *  it and switches to the receiver right away (Scheduler::handoff()), so a
+ *  request/reply pair costs two context switches and no trip through the
+ *  ready list. Likewise, a receiver that makes room passes the message of
+ *  the first waiting sender into the buffer.
+ *
+ *  Every waiting thread has a record on its stack that tells the other side
+ *  where to put or take its message. The waitingrooms drop the record in
+ *  remove(), so a thread that is killed or runs into its timeout while
+ *  waiting never gets a message; Waitingroom::remove() stops the timeout.
+ *
+ *  All methods must be called at epilogue level (see Guarded_Channel).
+ *  try_send() and try_recv() never block and may also be used by epilogues.
+ */
+template <typename T, unsigned N>
+class Channel {
+    // Disallow copies and assignments.
+    Channel(const Channel&)            = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    static_assert(N > 0, "a channel needs room for at least one message");
+
+    struct Waiter {
+        Thread *thread;
+        T *slot;        // receivers: where the message goes
+        const T *msg;   // senders: the message to take
+        bool done;      // set by the other side when it has taken over
+        Waiter *next;
+    };
+
+    class Room : public Waitingroom {
+        Room(const Room&)            = delete;
+        Room& operator=(const Room&) = delete;
+
+        Waiter *head;
+        Waiter *tail;
+
+    public:
+        Room() : head(nullptr), tail(nullptr) {}
+
+        Waiter *first() const {
+            return head;
+        }
+
+        void add(Waiter *w) {
+            w->next = nullptr;
+            if (tail) {
+                tail->next = w;
+            } else {
+                head = w;
+            }
+            tail = w;
+        }
+
+        // called by the scheduler for every way out of the room: wakeup,
+        // handoff, timeout and kill.
+        void remove(Thread *customer) override {
+            Waitingroom::remove(customer);
+
+            Waiter *prev = nullptr;
+            for (Waiter *w = head; w; prev = w, w = w->next) {
+                if (w->thread == customer) {
+                    if (prev) {
+                        prev->next = w->next;
+                    } else {
+                        head = w->next;
+                    }
+                    if (tail == w) {
+                        tail = prev;
+                    }
+                    return;
+                }
+            }
+        }
+    };
+
+    T buf[N];
+    unsigned first;
+    unsigned count;
+
+    Room receivers;
+    Room senders;
+
+    void push(const T &val) {
+        unsigned i = first + count;
+        buf[i >= N ? i - N : i] = val;
+        count++;
+    }
+
+    void pop(T &val) {
+        val = buf[first];
+        first = (first + 1 == N) ? 0 : first + 1;
+        count--;
+    }
+
+    // Blocks in "room" until the other side has set w.done, or for at most
+    // "ms" milliseconds (0 waits forever). Returns w.done.
+    static bool wait(Room &room, Waiter &w, unsigned int ms) {
+        w.thread = scheduler.active();
+        w.done = false;
+
+        Timeout timeout(w.thread, &room);
+        if (ms != 0) {
+            timeout.start(ms);
+        }
+
+        room.add(&w);
+        scheduler.block(&room);
+        return w.done;
+    }
+
+public:
+    Channel() : first(0), count(0) {}
+
+    /*! \brief Sends \p val, blocking while the channel is full.
+     */
+    void send(const T &val) {
+        if (Waiter *r = receivers.first()) {
+            *r->slot = val;
+            r->done = true;
+            scheduler.handoff(r->thread);
+        } else if (count < N) {
+            push(val);
+        } else {
+            Waiter w;
+            w.msg = &val;
+            wait(senders, w, 0);
+        }
+    }
+
+    /*! \brief Sends \p val if that is possible without blocking.
+     *  \return false if the channel is full
+     */
+    bool try_send(const T &val) {
+        if (Waiter *r = receivers.first()) {
+            *r->slot = val;
+            r->done = true;
+            scheduler.wakeup(r->thread);
+        } else if (count < N) {
+            push(val);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /*! \brief Receives a message into \p val if one is there.
+     *  \return false if the channel is empty
+     */
+    bool try_recv(T &val) {
+        if (count == 0) {
+            return false;
+        }
+
+        pop(val);
+        if (Waiter *s = senders.first()) {
+            push(*s->msg);
+            s->done = true;
+            scheduler.wakeup(s->thread);
+        }
+        return true;
+    }
+
+    /*! \brief Receives a message into \p val, blocking while the channel is
+     *  empty.
+     */
+    void recv(T &val) {
+        if (!try_recv(val)) {
+            Waiter w;
+            w.slot = &val;
+            wait(receivers, w, 0);
+        }
+    }
+
+    /*! \brief Receives a message into \p val, waiting at most \p ms
+     *  milliseconds for one.
+     *  \return false if no message arrived in time
+     */
+    bool recv(T &val, unsigned int ms) {
+        if (try_recv(val)) {
+            return true;
+        }
+        if (ms == 0) {
+            return false;
+        }
+
+        Waiter w;
+        w.slot = &val;
+        return wait(receivers, w, ms);
+    }
+};
@@ -0,0 +1,24 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/condvar.h"
+#include "thread/scheduler.h"
+#include "user/mutex/mutex.h"
+
+void ConditionVariable::wait(Mutex &m) {
+    m.unlock();
+    scheduler.block(this);
+    m.lock();
+}
+
+void ConditionVariable::notify_one() {
+    if (Thread *t = dequeue()) {
+        scheduler.wakeup(t);
+    }
+}
+
+void ConditionVariable::notify_all() {
+    Thread *t;
+    while ((t = dequeue()) != nullptr) {
+        scheduler.wakeup(t);
+    }
+}
@@ -0,0 +1,48 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class ConditionVariable.
+ */
+
+#pragma once
+
+#include "meeting/waitingroom.h"
+
+class Mutex;
+
+/*! \brief Lets threads wait for a condition on state protected by a Mutex.
+ *  \ingroup ipc
+ *
+ *  wait() releases the mutex and blocks in one step at epilogue level, so a
+ *  notify between checking the condition and going to sleep cannot get lost.
+ *  The mutex is held again when wait() returns. As another thread may have
+ *  changed the state in between, the condition must be checked in a loop:
+ *
+ *      m.lock();
+ *      while (!ready) {
+ *          cv.wait(m);
+ *      }
+ *      m.unlock();
+ *
+ *  All methods must be called at epilogue level (see
+ *  Guarded_ConditionVariable).
+ */
+class ConditionVariable : public Waitingroom {
+    // Disallow copies and assignments.
+    ConditionVariable(const ConditionVariable&)            = delete;
+    ConditionVariable& operator=(const ConditionVariable&) = delete;
+
+public:
+    ConditionVariable() {}
+
+    /*! \brief Releases \p m, waits for a notify and locks \p m again.
+     *  \param m Mutex held by the calling thread
+     */
+    void wait(Mutex &m);
+
+    //! \brief Wakes up the thread that has been waiting longest, if any.
+    void notify_one();
+
+    //! \brief Wakes up all waiting threads.
+    void notify_all();
+};
@@ -0,0 +1,65 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/pipe.h"
+
+void Pipe::wake_reader() {
+    if (reader_waiting) {
+        reader_waiting = false;
+        readable.v();
+    }
+}
+
+void Pipe::wake_writer() {
+    if (writer_waiting) {
+        writer_waiting = false;
+        writable.v();
+    }
+}
+
+size_t Pipe::write(const char *s, size_t len) {
+    size_t done = 0;
+    while (done < len && !read_closed) {
+        size_t space = SIZE - (head - tail);
+        if (space == 0) {
+            writer_waiting = true;
+            writable.p();
+            continue;
+        }
+
+        size_t n = (len - done < space) ? len - done : space;
+        for (size_t i = 0; i < n; i++) {
+            data[(head + i) & (SIZE - 1)] = s[done + i];
+        }
+        head += n;
+        done += n;
+        wake_reader();
+    }
+    return done;
+}
+
+size_t Pipe::read(char *buf, size_t len) {
+    while (head == tail && !write_closed) {
+        reader_waiting = true;
+        readable.p();
+    }
+
+    size_t n = (head - tail < len) ? head - tail : len;
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = data[(tail + i) & (SIZE - 1)];
+    }
+    tail += n;
+    if (n != 0) {
+        wake_writer();
+    }
+    return n;
+}
+
+void Pipe::close_write() {
+    write_closed = true;
+    wake_reader();
+}
+
+void Pipe::close_read() {
+    read_closed = true;
+    wake_writer();
+}
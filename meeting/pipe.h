@@ -0,0 +1,68 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Pipe.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "meeting/semaphore.h"
+
+/*! \brief Bounded byte buffer between one writing and one reading thread.
+ *  \ingroup ipc
+ *
+ *  A writer blocks while the pipe is full and a reader while it is empty. The
+ *  two semaphores are only used as wait queues: a side that has to wait
+ *  notes this and sleeps in p(), and the other side v()s it once it has
+ *  made progress. So a whole span is copied at once, instead of one p() and
+ *  v() per byte.
+ *
+ *  Each side closes its end when done: the reader then gets 0 once the pipe
+ *  is empty, and a writer whose reader is gone stops writing. All methods
+ *  must be called at epilogue level (see Guarded_Pipe).
+ */
+class Pipe {
+    // Disallow copies and assignments.
+    Pipe(const Pipe&)            = delete;
+    Pipe& operator=(const Pipe&) = delete;
+
+public:
+    static const size_t SIZE = 512;
+
+private:
+    static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+    char data[SIZE];
+    size_t head; // bytes written so far
+    size_t tail; // bytes read so far
+
+    Semaphore readable;
+    Semaphore writable;
+    bool reader_waiting;
+    bool writer_waiting;
+
+    bool write_closed;
+    bool read_closed;
+
+    void wake_reader();
+    void wake_writer();
+
+public:
+    Pipe() : head(0), tail(0), reader_waiting(false), writer_waiting(false),
+             write_closed(false), read_closed(false) {}
+
+    /*! \brief Writes all of \p s, blocking while the pipe is full.
+     *  \return \p len, or less if the reader has closed its end
+     */
+    size_t write(const char *s, size_t len);
+
+    /*! \brief Reads up to \p len bytes, blocking while the pipe is empty.
+     *  \return the number of bytes read, 0 once the writer has closed its
+     *          end and everything has been read
+     */
+    size_t read(char *buf, size_t len);
+
+    void close_write();
+    void close_read();
+};
@@ -0,0 +1,80 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/rwlock.h"
+#include "thread/scheduler.h"
+
+void RWLock::grant_read(Thread *t) {
+    readers++;
+    t->rwlock_hold(this);
+}
+
+void RWLock::grant_write(Thread *t) {
+    writer = t;
+    t->rwlock_hold(this);
+}
+
+bool RWLock::wake_writer() {
+    Thread *t = waiting_writers.dequeue();
+    if (!t) {
+        return false;
+    }
+    grant_write(t);
+    scheduler.wakeup(t);
+    return true;
+}
+
+void RWLock::wake_readers() {
+    Thread *t;
+    while ((t = waiting_readers.dequeue()) != nullptr) {
+        grant_read(t);
+        scheduler.wakeup(t);
+    }
+}
+
+void RWLock::read_lock() {
+    if (writer || waiting_writers.first() != nullptr) {
+        scheduler.block(&waiting_readers); // holds the lock when woken
+    } else {
+        grant_read(scheduler.active());
+    }
+}
+
+void RWLock::read_leave() {
+    // readers may also wait for a writer that has been killed meanwhile.
+    if (--readers == 0 && !wake_writer()) {
+        wake_readers();
+    }
+}
+
+void RWLock::read_unlock() {
+    scheduler.active()->rwlock_release(this);
+    read_leave();
+}
+
+void RWLock::write_lock() {
+    if (writer || readers != 0) {
+        scheduler.block(&waiting_writers); // holds the lock when woken
+    } else {
+        grant_write(scheduler.active());
+    }
+}
+
+void RWLock::write_leave() {
+    writer = nullptr;
+    if (!wake_writer()) {
+        wake_readers();
+    }
+}
+
+void RWLock::write_unlock() {
+    scheduler.active()->rwlock_release(this);
+    write_leave();
+}
+
+void RWLock::release(Thread *t) {
+    if (writer == t) {
+        write_leave();
+    } else {
+        read_leave();
+    }
+}
@@ -0,0 +1,62 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class RWLock.
+ */
+
+#pragma once
+
+#include "meeting/waitingroom.h"
+
+/*! \brief Lock that lets any number of readers or a single writer in.
+ *  \ingroup ipc
+ *
+ *  Writers are preferred: once a writer waits, new readers wait as well, so
+ *  a steady stream of readers cannot starve it. When a writer leaves, the
+ *  next waiting writer gets the lock; only if there is none, all waiting
+ *  readers are let in together.
+ *
+ *  The lock is handed over on wakeup: a woken thread already owns it and
+ *  does not have to compete for it again.
+ *
+ *  Like a Mutex, the lock is registered with each thread holding it, from
+ *  the moment it is handed over, so that it is released if the thread is
+ *  killed or exits while holding it (see Thread::rwlock_release_all()). A
+ *  thread may hold at most Thread::RWLOCKS_MAX of them at once.
+ *
+ *  All methods must be called at epilogue level (see Guarded_RWLock).
+ */
+class RWLock {
+    // Disallow copies and assignments.
+    RWLock(const RWLock&)            = delete;
+    RWLock& operator=(const RWLock&) = delete;
+
+    unsigned int readers; // threads holding the lock for reading
+    Thread *writer;       // thread holding the lock for writing
+
+    Waitingroom waiting_readers;
+    Waitingroom waiting_writers;
+
+    void grant_read(Thread *t);
+    void grant_write(Thread *t);
+    bool wake_writer();
+    void wake_readers();
+
+    // give the lock back, without the bookkeeping of the thread
+    void read_leave();
+    void write_leave();
+
+public:
+    RWLock() : readers(0), writer(nullptr) {}
+
+    /*! \brief Gives back the lock held by \p t, which is dying; called by
+     *  Thread::rwlock_release_all().
+     */
+    void release(Thread *t);
+
+    void read_lock();
+    void read_unlock();
+
+    void write_lock();
+    void write_unlock();
+};
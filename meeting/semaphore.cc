@@ -1,5 +1,6 @@
 #include "meeting/semaphore.h"
 #include "thread/scheduler.h"
+#include "meeting/timeout.h"
 
 void Semaphore::p() {
     if (counter > 0) {
@@ -9,6 +10,23 @@ void Semaphore::p() {
     }
 }
 
+bool Semaphore::p_timeout(unsigned int ms) {
+    if (counter > 0) {
+        counter--;
+        return true;
+    }
+    if (ms == 0) {
+        return false;
+    }
+
+    // v() passes its unit on to the thread it wakes, so being woken by
+    // anything but the timeout means having got the semaphore.
+    Timeout timeout(scheduler.active(), this);
+    timeout.start(ms);
+    scheduler.block(this);
+    return !timeout.fired();
+}
+
 void Semaphore::v() {
     Thread *t;
     if ((t = dequeue()) != nullptr) {
@@ -46,6 +46,17 @@ public:
 	 */
 	void p();
 
+	/*! \brief Wie p(), wartet aber höchstens \b ms Millisekunden.
+	 *
+	 *  Vor dem Blockieren wird ein Timeout gestellt. Wer zuerst kommt, v()
+	 *  oder der Timeout, holt den Thread aus der Warteliste; der jeweils
+	 *  andere findet ihn dort nicht mehr (siehe Waitingroom::remove()).
+	 *  \param ms Höchste Wartezeit; bei 0 wird gar nicht gewartet.
+	 *  \return \b true, falls der Semaphor belegt wurde, \b false, falls die
+	 *  Zeit abgelaufen ist.
+	 */
+	bool p_timeout(unsigned int ms);
+
 	/*! \brief Freigeben des kritischen Abschnitts.
 	 *
 	 *  Freigabeoperation: Wenn auf der Warteliste mindestens ein Thread
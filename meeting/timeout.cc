@@ -0,0 +1,37 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/timeout.h"
+#include "meeting/bellringer.h"
+#include "thread/scheduler.h"
+#include "debug/trace.h"
+
+void Timeout::start(unsigned int ms) {
+    armed = true;
+    rang = false;
+    thread->wait_timeout(this);
+    bellringer.job(this, ms);
+}
+
+void Timeout::cancel() {
+    if (armed) {
+        armed = false;
+        bellringer.cancel(this);
+        if (thread->wait_timeout() == this) {
+            thread->wait_timeout(nullptr);
+        }
+    }
+}
+
+void Timeout::ring() {
+    TRACE_EVENT(bell_fire, this);
+
+    // the bellringer removes the bell itself after ringing it.
+    armed = false;
+    if (thread->wait_timeout() == this) {
+        thread->wait_timeout(nullptr);
+    }
+    if (thread->waiting_in() == room) {
+        rang = true;
+        scheduler.wakeup(thread);
+    }
+}
@@ -0,0 +1,58 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Timeout.
+ */
+
+#pragma once
+
+#include "meeting/bell.h"
+
+class Thread;
+class Waitingroom;
+
+/*! \brief Bell that wakes one thread out of another waitingroom, to bound
+ *  how long it waits there.
+ *  \ingroup ipc
+ *
+ *  A thread that wants to wait for at most some milliseconds starts a
+ *  Timeout before it blocks. If the time runs out first, ring() takes the
+ *  thread out of the waitingroom and sets fired(). Otherwise, the thread
+ *  leaves the waitingroom through Waitingroom::remove(), which cancels the
+ *  timeout (start() registers it with the thread for that). This also
+ *  covers a thread being killed while waiting.
+ *
+ *  All methods must be called at epilogue level.
+ */
+class Timeout : public Bell {
+    // Disallow copies and assignments.
+    Timeout(const Timeout&)            = delete;
+    Timeout& operator=(const Timeout&) = delete;
+
+    Thread *thread;
+    Waitingroom *room;
+    bool armed;
+    bool rang;
+
+public:
+    Timeout(Thread *thread, Waitingroom *room)
+        : thread(thread), room(room), armed(false), rang(false) {}
+
+    ~Timeout() {
+        cancel();
+    }
+
+    //! \brief Rings after \p ms milliseconds (which must not be 0).
+    void start(unsigned int ms);
+
+    //! \brief Stops the timeout, if it is still running.
+    void cancel();
+
+    //! \brief true if the time ran out and ended the wait, i.e. nobody
+    //! else woke the thread before.
+    bool fired() const {
+        return rang;
+    }
+
+    void ring() override;
+};
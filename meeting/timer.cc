@@ -0,0 +1,56 @@
+// vim: set et ts=4 sw=4:
+
+#include "meeting/timer.h"
+#include "meeting/bellringer.h"
+#include "machine/clock.h"
+#include "debug/trace.h"
+
+void Timer::arm(uint64_t due, uint64_t period) {
+    cancel();
+    this->period = period;
+    this->due = due;
+    armed = true;
+
+    uint64_t now = Clock::now_ns();
+    uint64_t delay = due > now ? due - now : 0;
+    bellringer.job_at(this, due, slack_for(period ? period : delay));
+}
+
+void Timer::start(unsigned int ms, unsigned int period) {
+    arm(Clock::now_ns() + (uint64_t) ms * 1000000, (uint64_t) period * 1000000);
+}
+
+void Timer::start_us(unsigned int us, unsigned int period) {
+    arm(Clock::now_ns() + (uint64_t) us * 1000, (uint64_t) period * 1000);
+}
+
+void Timer::start_at(uint64_t deadline) {
+    arm(deadline, 0);
+}
+
+void Timer::cancel() {
+    if (armed) {
+        armed = false;
+        bellringer.cancel(this);
+    }
+}
+
+void Timer::ring() {
+    TRACE_EVENT(bell_fire, this);
+
+    // the bellringer has already taken the bell off its list. Rearm before
+    // the callback, so that it can cancel or restart the timer.
+    if (period != 0) {
+        uint64_t now = Clock::now_ns();
+        due += period;
+        while (due <= now) {
+            due += period;
+            skipped++;
+        }
+        bellringer.job_at(this, due, slack_for(period));
+    } else {
+        armed = false;
+    }
+
+    callback(arg);
+}
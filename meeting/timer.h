@@ -0,0 +1,78 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Timer.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "meeting/bell.h"
+
+/*! \brief Bell that calls a function instead of waking threads, once or
+ *  periodically.
+ *  \ingroup ipc
+ *
+ *  The callback runs in the epilogue of the timer interrupt (see
+ *  Bellringer::check_hires()), on the CPU that started the timer. It may
+ *  wake threads or start and cancel timers, including its own, but must not
+ *  block.
+ *
+ *  A periodic timer computes each deadline from the previous one, not from
+ *  the time the callback actually ran, so late epilogues do not add up. If
+ *  the callback is so late that whole periods have passed, those are skipped
+ *  and counted in overruns().
+ *
+ *  All methods must be called at epilogue level (see Guarded_Timer).
+ */
+class Timer : public Bell {
+    // Disallow copies and assignments.
+    Timer(const Timer&)            = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    void (*callback)(void *);
+    void *arg;
+    uint64_t due;       // deadline in ns, see Clock::now_ns()
+    uint64_t period;    // in ns, 0 for a one-shot timer
+    bool armed;
+    unsigned int skipped;
+
+    void arm(uint64_t due, uint64_t period);
+
+public:
+    Timer(void (*callback)(void *), void *arg = nullptr)
+        : callback(callback), arg(arg), due(0), period(0), armed(false), skipped(0) {}
+
+    ~Timer() {
+        cancel();
+    }
+
+    /*! \brief Calls the callback after \p ms milliseconds and then every
+     *  \p period milliseconds, or only once if \p period is 0.
+     *
+     *  Restarts the timer if it is already running.
+     */
+    void start(unsigned int ms, unsigned int period = 0);
+
+    //! \brief Like start(), in microseconds.
+    void start_us(unsigned int us, unsigned int period = 0);
+
+    //! \brief Calls the callback once at \p deadline (in ns, see
+    //! Clock::now_ns()), or as soon as possible if that has passed.
+    void start_at(uint64_t deadline);
+
+    //! \brief Stops the timer; the callback is not called anymore.
+    void cancel();
+
+    //! \brief true if the callback is still going to be called.
+    bool active() const {
+        return armed;
+    }
+
+    //! \brief Number of periods skipped because the callback came too late.
+    unsigned int overruns() const {
+        return skipped;
+    }
+
+    void ring() override;
+};
@@ -2,6 +2,8 @@
 
 #include "meeting/waitingroom.h"
 #include "syscall/guarded_scheduler.h"
+#include "meeting/timeout.h"
+#include "thread/thread.h"
 
 Waitingroom::~Waitingroom() {
     Thread *t;
@@ -11,5 +13,11 @@ Waitingroom::~Waitingroom() {
 }
 
 void Waitingroom::remove(Thread *customer) {
-    Queue::remove(customer);
+    List::remove(customer);
+
+    // however the thread leaves (wakeup, timeout or kill), a timeout that
+    // is still running for it must not ring anymore.
+    if (Timeout *t = customer->wait_timeout()) {
+        t->cancel();
+    }
 }
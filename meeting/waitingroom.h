@@ -14,7 +14,7 @@
  * (Semaphoren), als auch die Synchronisation mit der Umwelt (Bell).
  */
 
-#include "object/queue.h"
+#include "object/list.h"
 class Thread;
 
 /*! \brief Liste von Threads, die auf ein Ereignis warten.
@@ -22,7 +22,9 @@ class Thread;
  *
  *
  *  Die Klasse Waitingroom implementiert eine Liste von Threads, die alle auf
- *  ein bestimmtes Ereignis warten.
+ *  ein bestimmtes Ereignis warten. Die Liste ist doppelt verkettet, so dass
+ *  ein Thread beim Wecken, bei einem Timeout oder kill() in konstanter Zeit
+ *  aus ihr entfernt wird.
  *  \note
  *  Die Methode remove(Thread*) muss virtuell sein, damit der Scheduler einen
  *  Thread aus dem Wartezimmer entfernen kann, ohne wissen zu müssen, welcher
@@ -33,7 +35,7 @@ class Thread;
  *  definieren, ebenfalls virtuell sein.
  */
 class Waitingroom
-	: public Queue<Thread>
+	: public List<Thread>
 {
 	// Verhindere Kopien und Zuweisungen
 	Waitingroom(const Waitingroom&)            = delete;
@@ -55,6 +57,11 @@ public:
 	/*! \brief Mit dieser Methode kann der angegebene Thread customer vorzeitig
 	 *  aus dem Wartezimmer entfernt werden.
 	 *
+	 *  Der Scheduler ruft sie auf jedem Weg aus dem Wartezimmer auf (wakeup,
+	 *  handoff, kill). Sie hält auch einen Timeout an, der das Warten von
+	 *  customer begrenzt; abgeleitete Klassen müssen daher die Methode der
+	 *  Basisklasse aufrufen.
+	 *
 	 *
 	 *  \todo Methode implementieren
 	 *
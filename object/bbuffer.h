@@ -1,7 +1,7 @@
 // vim: set et ts=4 sw=4:
 
 /*! \file
- *  \brief Enthält die Klasse BBuffer
+ *  \brief Enthält die Ringpuffer BBuffer und MPMC_BBuffer
  */
 
 #pragma once
@@ -11,6 +11,13 @@
 /*! \brief Die Klasse BBuffer implementiert einen "Bounded Buffer",
  *  also einen Puffer mit beschränkter Größe.
  *
+ *  Es darf nur einen Produzenten und einen Konsumenten geben, die aber auf
+ *  verschiedenen CPUs laufen dürfen: Der Produzent veröffentlicht ein Element
+ *  mit einem release-Store auf \c in, den der Konsument mit einem
+ *  acquire-Load liest (und umgekehrt für \c out). Die Indizes laufen frei
+ *  über und werden erst beim Zugriff maskiert, daher muss \p CAP eine
+ *  Zweierpotenz sein; dafür passen auch genau \p CAP Elemente hinein.
+ *
  *  \tparam T gibt an welcher Typ gespeichert werden soll
  *  \tparam CAP gibt die Kapazität des Puffers an.
  */
@@ -21,10 +28,12 @@ class BBuffer
 	BBuffer(const BBuffer&)            = delete;
 	BBuffer& operator=(const BBuffer&) = delete;
 
+    static_assert(CAP != 0 && (CAP & (CAP - 1)) == 0, "CAP must be a power of two");
+
 private:
 	T data[CAP];
-	volatile unsigned in;
-	volatile unsigned out;
+	unsigned in;  // nur vom Produzenten geschrieben
+	unsigned out; // nur vom Konsumenten geschrieben
 
 public:
 	/*! \brief Der Konstruktor initialisiert den Puffer als leer.
@@ -38,13 +47,13 @@ public:
 	 *  mehr eingefügt werden kann, \b true sonst.
 	 */
 	bool produce(T val) {
-		unsigned nextin = (in + 1) % CAP;
-		if(nextin != out) {
-			data[in] = val;
-			in = nextin;
-			return true;
-		}
-		return false;
+        unsigned i = in;
+        if (i - __atomic_load_n(&out, __ATOMIC_ACQUIRE) == CAP) {
+            return false;
+        }
+        data[i & (CAP - 1)] = val;
+        __atomic_store_n(&in, i + 1, __ATOMIC_RELEASE);
+        return true;
 	}
 
 	/*! \brief Aus dem Puffer herausnehmen.
@@ -53,12 +62,108 @@ public:
 	 *  \return \b false wenn der Puffer leer ist, \b true sonst.
 	 */
 	bool consume(T &val) {
-        if(in != out) {
-            val = data[out];
-            out = (out + 1) % CAP;
-            return true;
+        unsigned o = out;
+        if (o == __atomic_load_n(&in, __ATOMIC_ACQUIRE)) {
+            return false;
         }
-        return false;
+        val = data[o & (CAP - 1)];
+        __atomic_store_n(&out, o + 1, __ATOMIC_RELEASE);
+        return true;
     }
 };
 
+/*! \brief Ringpuffer für beliebig viele Produzenten und Konsumenten (nach
+ *  Dmitry Vyukov), ohne Sperren.
+ *
+ *  Jede Zelle trägt eine Sequenznummer, die angibt, für welchen Durchlauf sie
+ *  gerade beschrieben bzw. gelesen werden darf. Produzenten und Konsumenten
+ *  reservieren sich eine Zelle, indem sie \c in bzw. \c out per CAS
+ *  weiterzählen, und geben sie danach mit einem release-Store der
+ *  Sequenznummer an die jeweils andere Seite weiter.
+ *
+ *  Da nie auf eine andere CPU oder einen anderen Faden gewartet wird, darf der
+ *  Puffer auch aus Prologen heraus benutzt werden: Unterbricht ein Interrupt
+ *  einen Produzenten zwischen Reservieren und Veröffentlichen, meldet
+ *  consume() an dieser Stelle nur vorübergehend einen leeren Puffer.
+ *
+ *  \tparam T gibt an welcher Typ gespeichert werden soll
+ *  \tparam CAP gibt die Kapazität des Puffers an, eine Zweierpotenz.
+ */
+template <typename T, unsigned CAP>
+class MPMC_BBuffer
+{
+	// Verhindere Kopien und Zuweisungen
+	MPMC_BBuffer(const MPMC_BBuffer&)            = delete;
+	MPMC_BBuffer& operator=(const MPMC_BBuffer&) = delete;
+
+    static_assert(CAP >= 2 && (CAP & (CAP - 1)) == 0, "CAP must be a power of two");
+
+private:
+    struct Cell {
+        unsigned seq;
+        T val;
+    };
+
+    Cell cells[CAP];
+
+    // in eigenen Cache-Zeilen, damit sich Produzenten und Konsumenten nicht
+    // gegenseitig die Zeile wegnehmen.
+    unsigned in  __attribute__((aligned(64)));
+    unsigned out __attribute__((aligned(64)));
+
+public:
+	MPMC_BBuffer() : in(0), out(0) {
+        for (unsigned i = 0; i < CAP; i++) {
+            cells[i].seq = i;
+        }
+    }
+
+	/// \copydoc BBuffer::produce()
+	bool produce(T val) {
+        unsigned pos = __atomic_load_n(&in, __ATOMIC_RELAXED);
+        Cell *cell;
+        for (;;) {
+            cell = &cells[pos & (CAP - 1)];
+            int diff = (int) (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+            if (diff == 0) {
+                // on failure, pos is updated to the current value of in
+                if (__atomic_compare_exchange_n(&in, &pos, pos + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // the cell still holds the value from the previous lap
+            } else {
+                pos = __atomic_load_n(&in, __ATOMIC_RELAXED);
+            }
+        }
+
+        cell->val = val;
+        __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+	}
+
+	/// \copydoc BBuffer::consume()
+	bool consume(T &val) {
+        unsigned pos = __atomic_load_n(&out, __ATOMIC_RELAXED);
+        Cell *cell;
+        for (;;) {
+            cell = &cells[pos & (CAP - 1)];
+            int diff = (int) (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+            if (diff == 0) {
+                if (__atomic_compare_exchange_n(&out, &pos, pos + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // not yet written (in this lap)
+            } else {
+                pos = __atomic_load_n(&out, __ATOMIC_RELAXED);
+            }
+        }
+
+        val = cell->val;
+        __atomic_store_n(&cell->seq, pos + CAP, __ATOMIC_RELEASE);
+        return true;
+    }
+};
@@ -0,0 +1,296 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains format(), a type-safe formatted output for O_Stream whose
+ *  format string is parsed at compile time.
+ *  \ingroup io
+ *
+ *  The format string is wrapped with FMT(), which turns it into a type. All
+ *  parsing happens in constexpr functions during template instantiation, so a
+ *  call compiles down to the same put()s as the equivalent chain of `<<`:
+ *
+ *      format(kout, FMT("RAM: {:3}% ({}/{})\n"), used, blocks, total);
+ *      format(dout, FMT("{:#010x} {:-<8}|"), addr, name);
+ *
+ *  A placeholder is `{}` or `{:spec}`, where spec is
+ *  `[[fill]<|>][#][0][width][b|o|d|x]`:
+ *  - `<` or `>` pads on the right or left (default), with fill (default ' ')
+ *  - `#` prefixes the number with its base (`0b`, `0`, `0x`)
+ *  - `0` pads with zeros between sign/prefix and digits
+ *  - `b`, `o`, `d` and `x` select the base (default 10)
+ *
+ *  Literal braces are written as `{{` and `}}`. A malformed format string or
+ *  a wrong number of arguments is a compile error. Unlike `<<`, format() does
+ *  not flush and does not change the base of the stream.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "object/o_stream.h"
+#include "user/string/string.h"
+
+/*! \def FMT(str)
+ *  \brief Turns the string literal \p str into a format string for format().
+ */
+#define FMT(str) ([] { \
+        struct Format_String { \
+            static constexpr const char *get() { return str; } \
+        }; \
+        return Format_String(); \
+    }())
+
+namespace Format_Detail {
+
+enum Kind { END, TEXT, ESCAPE, FIELD, ERROR };
+
+constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_align(char c) {
+    return c == '<' || c == '>';
+}
+
+// kind of the token starting at s[i]
+constexpr int kind(const char *s, unsigned i) {
+    return s[i] == '\0' ? END
+         : s[i] == '{'  ? (s[i + 1] == '{' ? ESCAPE : FIELD)
+         : s[i] == '}'  ? (s[i + 1] == '}' ? ESCAPE : ERROR)
+         : TEXT;
+}
+
+constexpr unsigned text_end(const char *s, unsigned i) {
+    return (s[i] == '\0' || s[i] == '{' || s[i] == '}') ? i : text_end(s, i + 1);
+}
+
+constexpr unsigned skip_digits(const char *s, unsigned i) {
+    return is_digit(s[i]) ? skip_digits(s, i + 1) : i;
+}
+
+constexpr unsigned number(const char *s, unsigned i, unsigned value) {
+    return is_digit(s[i]) ? number(s, i + 1, value * 10 + (s[i] - '0')) : value;
+}
+
+// The following functions take the position of the '{' of a field and
+// return the individual parts of its spec, one step after the other.
+
+constexpr unsigned spec_begin(const char *s, unsigned i) {
+    return s[i + 1] == ':' ? i + 2 : i + 1;
+}
+
+constexpr bool has_fill(const char *s, unsigned i) {
+    return s[spec_begin(s, i)] != '\0' && s[spec_begin(s, i)] != '}'
+        && is_align(s[spec_begin(s, i) + 1]);
+}
+
+constexpr unsigned after_align(const char *s, unsigned i) {
+    return has_fill(s, i) ? spec_begin(s, i) + 2
+         : is_align(s[spec_begin(s, i)]) ? spec_begin(s, i) + 1
+         : spec_begin(s, i);
+}
+
+constexpr bool aligned(const char *s, unsigned i) {
+    return after_align(s, i) != spec_begin(s, i);
+}
+
+constexpr bool left(const char *s, unsigned i) {
+    return aligned(s, i) && s[after_align(s, i) - 1] == '<';
+}
+
+constexpr bool prefix(const char *s, unsigned i) {
+    return s[after_align(s, i)] == '#';
+}
+
+constexpr unsigned after_prefix(const char *s, unsigned i) {
+    return after_align(s, i) + (prefix(s, i) ? 1 : 0);
+}
+
+constexpr bool zero(const char *s, unsigned i) {
+    return !aligned(s, i) && s[after_prefix(s, i)] == '0';
+}
+
+constexpr unsigned width_begin(const char *s, unsigned i) {
+    return after_prefix(s, i) + (zero(s, i) ? 1 : 0);
+}
+
+constexpr unsigned width(const char *s, unsigned i) {
+    return number(s, width_begin(s, i), 0);
+}
+
+constexpr char fill(const char *s, unsigned i) {
+    return has_fill(s, i) ? s[spec_begin(s, i)] : zero(s, i) ? '0' : ' ';
+}
+
+constexpr unsigned type_pos(const char *s, unsigned i) {
+    return skip_digits(s, width_begin(s, i));
+}
+
+// 0 if the type is unknown
+constexpr unsigned base(const char *s, unsigned i) {
+    return s[type_pos(s, i)] == 'b' ? 2
+         : s[type_pos(s, i)] == 'o' ? 8
+         : s[type_pos(s, i)] == 'x' ? 16
+         : (s[type_pos(s, i)] == 'd' || s[type_pos(s, i)] == '}') ? 10
+         : 0;
+}
+
+// position of the closing '}'
+constexpr unsigned field_end(const char *s, unsigned i) {
+    return type_pos(s, i) + (s[type_pos(s, i)] == '}' ? 0 : 1);
+}
+
+constexpr bool field_valid(const char *s, unsigned i) {
+    return (s[i + 1] == '}' || s[i + 1] == ':')
+        && base(s, i) != 0 && width(s, i) < 256 && s[field_end(s, i)] == '}';
+}
+
+// number of fields, or -1 if the format string is malformed
+constexpr int count(const char *s, unsigned i) {
+    return kind(s, i) == END    ? 0
+         : kind(s, i) == TEXT   ? count(s, text_end(s, i))
+         : kind(s, i) == ESCAPE ? count(s, i + 2)
+         : kind(s, i) == FIELD && field_valid(s, i)
+             ? (count(s, field_end(s, i) + 1) < 0 ? -1 : 1 + count(s, field_end(s, i) + 1))
+         : -1;
+}
+
+// Writers for the supported argument types
+
+inline void write(O_Stream &os, const Format_Spec &spec, int v) {
+    bool negative = spec.base == 10 && v < 0;
+    os.put_number(negative ? 0u - (unsigned int) v : (unsigned int) v, negative, spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, unsigned int v) {
+    os.put_number(v, false, spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, long long v) {
+    bool negative = spec.base == 10 && v < 0;
+    os.put_number(negative ? 0ull - (unsigned long long) v : (unsigned long long) v, negative, spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, unsigned long long v) {
+    os.put_number(v, false, spec);
+}
+
+// long is only wider than 32 bit when the streams are tested on a 64-bit host
+inline void write(O_Stream &os, const Format_Spec &spec, long v) {
+    if (sizeof(long) > sizeof(int)) {
+        write(os, spec, (long long) v);
+    } else {
+        write(os, spec, (int) v);
+    }
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, unsigned long v) {
+    if (sizeof(unsigned long) > sizeof(unsigned int)) {
+        write(os, spec, (unsigned long long) v);
+    } else {
+        write(os, spec, (unsigned int) v);
+    }
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, short v) {
+    write(os, spec, (int) v);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, unsigned short v) {
+    write(os, spec, (unsigned int) v);
+}
+
+// characters are printed as such, like with operator<<
+inline void write(O_Stream &os, const Format_Spec &spec, char c) {
+    os.put_field(&c, 1, spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, unsigned char c) {
+    write(os, spec, (char) c);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, bool b) {
+    os.put_field(b ? "true" : "false", b ? 4 : 5, spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, const char *str) {
+    os.put_field(str, strlen(str), spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, char *str) {
+    write(os, spec, (const char *) str);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, const StringView &str) {
+    os.put_field(str.data(), str.length(), spec);
+}
+
+inline void write(O_Stream &os, const Format_Spec &spec, const String &str) {
+    write(os, spec, StringView(str));
+}
+
+// other pointers are printed as addresses, in hex unless told otherwise
+template <typename T>
+inline void write(O_Stream &os, const Format_Spec &spec, T *ptr) {
+    Format_Spec addr(spec.base == 10 ? 16 : spec.base, true, spec.width, spec.fill, spec.left);
+    write(os, addr, (unsigned long) ptr);
+}
+
+template <typename F, unsigned I, int K = kind(F::get(), I)>
+struct Run;
+
+template <typename F, unsigned I>
+struct Run<F, I, END> {
+    static void go(O_Stream &os) {
+        (void) os;
+    }
+};
+
+template <typename F, unsigned I>
+struct Run<F, I, TEXT> {
+    template <typename... Args>
+    static void go(O_Stream &os, const Args&... args) {
+        os.append(F::get() + I, text_end(F::get(), I) - I);
+        Run<F, text_end(F::get(), I)>::go(os, args...);
+    }
+};
+
+template <typename F, unsigned I>
+struct Run<F, I, ESCAPE> {
+    template <typename... Args>
+    static void go(O_Stream &os, const Args&... args) {
+        os.append(F::get() + I, 1);
+        Run<F, I + 2>::go(os, args...);
+    }
+};
+
+template <typename F, unsigned I>
+struct Run<F, I, FIELD> {
+    template <typename T, typename... Args>
+    static void go(O_Stream &os, const T &arg, const Args&... args) {
+        constexpr Format_Spec spec(base(F::get(), I), prefix(F::get(), I), width(F::get(), I),
+                                   fill(F::get(), I), left(F::get(), I));
+        write(os, spec, arg);
+        Run<F, field_end(F::get(), I) + 1>::go(os, args...);
+    }
+};
+
+} // namespace Format_Detail
+
+/*! \brief Writes \p args into \p os as described by the format string \p fmt.
+ *
+ *  \param os Stream to write into; it is not flushed
+ *  \param fmt Format string created with FMT()
+ *  \param args One argument per placeholder
+ *  \return \p os, so that `<< flush` can follow
+ */
+template <typename F, typename... Args>
+O_Stream& format(O_Stream &os, F fmt, const Args&... args) {
+    (void) fmt;
+    static_assert(Format_Detail::count(F::get(), 0) >= 0, "malformed format string");
+    static_assert(Format_Detail::count(F::get(), 0) < 0
+                  || Format_Detail::count(F::get(), 0) == (int) sizeof...(Args),
+                  "number of arguments does not match the format string");
+    Format_Detail::Run<F, 0>::go(os, args...);
+    return os;
+}
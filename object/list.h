@@ -0,0 +1,194 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the classes List and ListLink.
+ */
+
+#pragma once
+
+#include "object/queuelink.h"
+
+template<typename T> class ListLink;
+template<typename T, ListLink<T> T::*> class List;
+
+/*! \brief Links an object into a doubly linked List.
+ *
+ *  The counterpart of QueueLink: a class whose objects are kept in a List
+ *  contains a ListLink<T> member, by default named "list_link".
+ */
+template<typename T>
+class ListLink {
+    template<typename X, ListLink<X> X::* x> friend class List;
+
+    T *prev;
+    T *next;
+    const void *list; // the list the object is in, or nullptr
+
+public:
+    ListLink() : prev(nullptr), next(nullptr), list(nullptr) {}
+};
+
+// Gets either the member given as template argument or "list_link", like
+// queue_link_get in object/queuelink.h.
+template<typename X, ListLink<X> X::* link_field, class Enable = void>
+struct list_link_get {
+    static ListLink<X> *call(X *o) {
+        return &(o->list_link);
+    }
+};
+
+template<typename X, ListLink<X> X::* link_field>
+struct list_link_get<X, link_field, typename enable_if<link_field != nullptr>::type> {
+    static ListLink<X> *call(X *o) {
+        return &(o->*link_field);
+    }
+};
+
+/*! \brief Doubly linked list of objects, with the interface of Queue.
+ *
+ *  Each element knows its predecessor, so remove() takes constant time
+ *  instead of searching the list like Queue::remove(). This costs one more
+ *  pointer per element; Queue is still the right choice for lists that are
+ *  only used in FIFO order.
+ *
+ *  Like with Queue, an object can be in only one list per link member. Each
+ *  link remembers its list, so contains() and remove() also work for lists
+ *  that share a link member. Unless NDEBUG is defined, inserting an object
+ *  that is still in a list stops the CPU with an invalid opcode exception.
+ *  (This header is also used by the host tests, so it cannot use the assert
+ *  of debug/assert.h.)
+ */
+template<typename T, ListLink<T> T::* link_field = nullptr>
+class List {
+    // Disallow copies and assignments.
+    List(const List&)            = delete;
+    List& operator=(const List&) = delete;
+
+    T *head;
+    T *tail;
+
+    // links "item" in between "prev" and "next", either of which may be
+    // nullptr at the ends of the list.
+    void link(T *item, T *prev, T *next) {
+        ListLink<T> *node = get_node(item);
+#ifndef NDEBUG
+        if (__builtin_expect(node->list != nullptr, 0)) {
+            __builtin_trap();
+        }
+#endif
+        node->list = this;
+        node->prev = prev;
+        node->next = next;
+        if (prev) {
+            get_node(prev)->next = item;
+        } else {
+            head = item;
+        }
+        if (next) {
+            get_node(next)->prev = item;
+        } else {
+            tail = item;
+        }
+    }
+
+public:
+    List() : head(nullptr), tail(nullptr) {}
+
+    static ListLink<T> *get_node(T *o) {
+        return list_link_get<T, link_field>::call(o);
+    }
+
+    //! \brief Appends \p item to the end of the list.
+    void enqueue(T *item) {
+        link(item, tail, nullptr);
+    }
+
+    //! \brief Removes the first element and returns it, or nullptr if the
+    //! list is empty.
+    T *dequeue() {
+        T *out = head;
+        if (out) {
+            remove(out);
+        }
+        return out;
+    }
+
+    //! \brief true if \p item is in this list.
+    bool contains(T *item) {
+        return get_node(item)->list == this;
+    }
+
+    /*! \brief Removes \p item from the list, in constant time.
+     *  \return \p item, or nullptr if it was not in the list.
+     */
+    T *remove(T *item) {
+        if (!contains(item)) {
+            return nullptr;
+        }
+        ListLink<T> *node = get_node(item);
+        if (node->prev) {
+            get_node(node->prev)->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            get_node(node->next)->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        node->prev = nullptr;
+        node->next = nullptr;
+        node->list = nullptr;
+        return item;
+    }
+
+    //! \brief Inserts \p item at the front of the list.
+    void insert_first(T *item) {
+        link(item, nullptr, head);
+    }
+
+    //! \brief Inserts \p new_item behind \p old_item, which is in the list.
+    void insert_after(T *old_item, T *new_item) {
+        link(new_item, old_item, get_node(old_item)->next);
+    }
+
+    //! \brief Returns the first element without removing it.
+    T *first() {
+        return head;
+    }
+
+    //! \brief Returns the element after \p o, or nullptr.
+    T *next(T *o) {
+        return get_node(o)->next;
+    }
+
+    //! \brief Forward iterator for range-based for loops. Unlike with
+    //! Queue, the current element must not be removed in the loop.
+    class Iterator {
+        T *current;
+
+    public:
+        Iterator(T *current = nullptr) : current(current) {}
+
+        bool operator!=(const Iterator& other) {
+            return current != other.current;
+        }
+
+        T *operator*() {
+            return current;
+        }
+
+        Iterator& operator++() {
+            current = get_node(current)->next;
+            return *this;
+        }
+    };
+
+    Iterator begin() {
+        return Iterator(head);
+    }
+
+    Iterator end() {
+        return Iterator();
+    }
+};
@@ -3,6 +3,7 @@
 #include "o_stream.h"
 #include "types.h"
 #include "debug/output.h"
+#include "utils/math.h"
 
 O_Stream& O_Stream::operator <<(char c) {
 	put(c);
@@ -15,9 +16,11 @@ O_Stream& O_Stream::operator <<(unsigned char c) {
 }
 
 O_Stream& O_Stream::operator <<(const char* string) {
-	for (const char *c = string; *c != '\0'; c++) {
-		put(*c);
+	const char *end = string;
+	while (*end != '\0') {
+		end++;
 	}
+	put(string, end - string);
 	return *this;
 }
 
@@ -26,55 +29,202 @@ O_Stream& O_Stream::operator <<(bool b) {
 }
 
 O_Stream& O_Stream::operator <<(short ival) {
-    return *this << (long) ival;
+    return *this << (int) ival;
 }
 
 O_Stream& O_Stream::operator <<(unsigned short ival) {
-    return *this << (unsigned long) ival;
+    return *this << (unsigned int) ival;
 }
 
 O_Stream& O_Stream::operator <<(int ival) {
-    return *this << (long) ival;
+    bool negative = base == 10 && ival < 0;
+    put_number(negative ? 0u - (unsigned int) ival : (unsigned int) ival, negative);
+    return *this;
 }
 
 O_Stream& O_Stream::operator <<(unsigned int ival) {
-    return *this << (unsigned long) ival;
+    put_number(ival, false);
+    return *this;
 }
 
+// long is only wider than 32 bit when the streams are tested on a 64-bit host
 O_Stream& O_Stream::operator <<(long ival) {
-    if (base == 10 && ival < 0) {
-        put('-');
-        ival = -ival;
+    if (sizeof(long) > sizeof(int)) {
+        return *this << (long long) ival;
     }
-    return *this << (unsigned long) ival;
+    return *this << (int) ival;
 }
 
 O_Stream& O_Stream::operator <<(unsigned long ival) {
+    if (sizeof(unsigned long) > sizeof(unsigned int)) {
+        return *this << (unsigned long long) ival;
+    }
+    return *this << (unsigned int) ival;
+}
+
+O_Stream& O_Stream::operator <<(long long ival) {
+    bool negative = base == 10 && ival < 0;
+    put_number(negative ? 0ull - (unsigned long long) ival : (unsigned long long) ival, negative);
+    return *this;
+}
+
+O_Stream& O_Stream::operator <<(unsigned long long ival) {
+    put_number(ival, false);
+    return *this;
+}
+
+// two decimal digits per entry, "00" to "99"
+static const char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// All format functions write the digits backwards, ending right before "end",
+// and return a pointer to the first digit.
+
+static char *format_dec(char *end, unsigned int ival) {
+    while (ival >= 100) {
+        const char *pair = &digit_pairs[(ival % 100) * 2];
+        ival /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (ival >= 10) {
+        const char *pair = &digit_pairs[ival * 2];
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = '0' + ival;
+    }
+    return end;
+}
+
+static char *format_dec(char *end, unsigned long long ival) {
+    // split off blocks of nine digits, so that only those need a 64-bit division
+    while (ival > 0xffffffff) {
+        uint64_t rem;
+        ival = Math::div64(ival, 1000000000, &rem);
+        char *start = format_dec(end, (unsigned int) rem);
+        while (end - start < 9) {
+            *--start = '0';
+        }
+        end = start;
+    }
+    return format_dec(end, (unsigned int) ival);
+}
+
+template <typename T>
+static char *format_pow2(char *end, T ival, unsigned shift) {
+    const unsigned mask = (1u << shift) - 1;
+    do {
+        *--end = digits[ival & mask];
+        ival >>= shift;
+    } while (ival != 0);
+    return end;
+}
+
+static char *format_any(char *end, unsigned int ival, unsigned int base) {
+    do {
+        *--end = digits[ival % base];
+        ival /= base;
+    } while (ival != 0);
+    return end;
+}
+
+static char *format_any(char *end, unsigned long long ival, unsigned int base) {
+    do {
+        uint64_t rem;
+        ival = Math::div64(ival, base, &rem);
+        *--end = digits[rem];
+    } while (ival != 0);
+    return end;
+}
+
+template <typename T>
+static char *format(char *end, T ival, int base) {
     switch (base) {
-    case 2:
-        put('0'); put('b');
-        break;
-    case 8:
-        put('0');
-        break;
-    case 10:
-        break;
-    case 16:
-        put('0'); put('x');
-        break;
+    case 2:  return format_pow2(end, ival, 1);
+    case 8:  return format_pow2(end, ival, 3);
+    case 10: return format_dec(end, ival);
+    case 16: return format_pow2(end, ival, 4);
+    default: return format_any(end, ival, base);
     }
+}
 
-    unsigned long div; // biggest power of base thats smaller than ival
-    for (div = 1; ival / div >= (unsigned long) base; div *= base);
+// writes sign and base prefix backwards like the format functions
+static char *format_prefix(char *end, bool negative, const Format_Spec &spec) {
+    if (spec.prefix) {
+        switch (spec.base) {
+        case 2:  *--end = 'b'; *--end = '0'; break;
+        case 8:  *--end = '0'; break;
+        case 16: *--end = 'x'; *--end = '0'; break;
+        }
+    }
+    if (negative) {
+        *--end = '-';
+    }
+    return end;
+}
 
-    for (; div > 0; div /= (unsigned long) base) {
-        char digit = ival / div;
-        put(digit + ((digit < 10) ? '0' : ('a' - 10)));
+void O_Stream::put_field(const char *prefix, size_t prefix_len, const char *s, size_t len,
+                         const Format_Spec &spec) {
+    size_t pad = spec.width > prefix_len + len ? spec.width - prefix_len - len : 0;
+    if (pad == 0) {
+        put(prefix, prefix_len);
+        put(s, len);
+        return;
+    }
 
-        ival %= div;
+    if (!spec.left && spec.fill != '0') {
+        for (; pad > 0; pad--) {
+            put(spec.fill);
+        }
+    }
+    put(prefix, prefix_len);
+    if (!spec.left) {
+        for (; pad > 0; pad--) {
+            put(spec.fill);
+        }
+    }
+    put(s, len);
+    for (; pad > 0; pad--) {
+        put(spec.fill);
     }
+}
 
-    return *this;
+void O_Stream::put_number(unsigned int ival, bool negative, const Format_Spec &spec) {
+    char buf[3 + 8 * sizeof(ival)]; // sign + prefix + binary digits
+    char *end    = buf + sizeof(buf);
+    char *digits = format(end, ival, spec.base);
+    char *start  = format_prefix(digits, negative, spec);
+    put_field(start, digits - start, digits, end - digits, spec);
+}
+
+void O_Stream::put_number(unsigned long long ival, bool negative, const Format_Spec &spec) {
+    char buf[3 + 8 * sizeof(ival)];
+    char *end    = buf + sizeof(buf);
+    char *digits = format(end, ival, spec.base);
+    char *start  = format_prefix(digits, negative, spec);
+    put_field(start, digits - start, digits, end - digits, spec);
+}
+
+// operator<< never pads, so sign, prefix and digits go into the buffer at once
+void O_Stream::put_number(unsigned int ival, bool negative) {
+    char buf[3 + 8 * sizeof(ival)];
+    char *end   = buf + sizeof(buf);
+    char *start = format_prefix(format(end, ival, base), negative, Format_Spec(base, true));
+    put(start, end - start);
+}
+
+void O_Stream::put_number(unsigned long long ival, bool negative) {
+    char buf[3 + 8 * sizeof(ival)];
+    char *end   = buf + sizeof(buf);
+    char *start = format_prefix(format(end, ival, base), negative, Format_Spec(base, true));
+    put(start, end - start);
 }
 
 O_Stream& O_Stream::operator <<(const void* ptr) {
@@ -90,7 +240,7 @@ O_Stream& O_Stream::operator <<(O_Stream& (*f) (O_Stream&)) {
 	return f(*this);
 }
 
-O_Stream& O_Stream::operator <<(Time& t) {
+O_Stream& O_Stream::operator <<(const Time& t) {
     *this << Time::get_weekday_string(t.weekday)
           << ((t.day     < 10) ? "  " : " ") << t.day
           << " " << t.get_month_string(t.month)
@@ -104,9 +254,11 @@ O_Stream& O_Stream::operator <<(Time& t) {
 }
 
 O_Stream& O_Stream::operator <<(String& str) {
-    for (char c : str) {
-        *this << c;
-    }
+    return *this << StringView(str);
+}
+
+O_Stream& O_Stream::operator <<(const StringView& str) {
+    put(str.data(), str.length());
     return *this;
 }
 
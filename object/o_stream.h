@@ -40,6 +40,21 @@
 #include "user/string/string.h"
 #include "machine/cgascr.h"
 
+/*! \brief Darstellungsoptionen für ein einzelnes Argument von format()
+ *  (siehe object/format.h).
+ */
+struct Format_Spec {
+	uint8_t base;   ///< Basis des Zahlensystems
+	bool prefix;    ///< Präfix der Basis (\c 0b, \c 0, \c 0x) voranstellen
+	uint8_t width;  ///< Mindestanzahl der ausgegebenen Zeichen
+	char fill;      ///< Zeichen zum Auffüllen auf \c width
+	bool left;      ///< Linksbündig ausgeben, also rechts auffüllen
+
+	constexpr Format_Spec(uint8_t base = 10, bool prefix = false, uint8_t width = 0,
+	                      char fill = ' ', bool left = false)
+		: base(base), prefix(prefix), width(width), fill(fill), left(left) {}
+};
+
 /*! \brief Die Aufgaben der Klasse O_Stream entsprechen im Wesentlichen denen der
  *  Klasse ostream der bekannten C++ IO-Streams-Bibliothek.
  *
@@ -74,6 +89,24 @@ class O_Stream : public Stringbuffer {
 	O_Stream(const O_Stream&)            = delete;
 	O_Stream& operator=(const O_Stream&) = delete;
 
+	/*! \brief Formatiert eine Zahl im Zahlensystem zur Basis base und fügt
+	 *  sie am Stück in den Puffer ein.
+	 *  \param ival Betrag der Zahl
+	 *  \param negative Gibt an, ob ein Minuszeichen vorangestellt werden soll
+	 */
+	void put_number(unsigned int ival, bool negative);
+
+	/// \copydoc O_Stream::put_number(unsigned int, bool)
+	void put_number(unsigned long long ival, bool negative);
+
+	/*! \brief Fügt \p prefix und \p s ein und füllt dabei gemäß \p spec
+	 *  auf dessen Mindestbreite auf.
+	 *
+	 *  Beim Auffüllen mit Nullen stehen diese zwischen Präfix und Ziffern.
+	 */
+	void put_field(const char *prefix, size_t prefix_len, const char *s, size_t len,
+	               const Format_Spec &spec);
+
 public:
 	/*! \brief Basis des zur Anzeige verwendeten Zahlensystems (z.B. 2, 8, 10 oder 16)
 	 *
@@ -82,8 +115,10 @@ public:
 
 	/*! \brief Konstruktor; Initale Zahlenbasis ist das Dezimalsystem.
 	 *
+	 *  \param buffer Zeichenpuffer mit Platz für \p size Zeichen
+	 *  \param size Größe des Zeichenpuffers
 	 */
-	O_Stream() {
+	O_Stream(char *buffer, int size) : Stringbuffer(buffer, size) {
 		base = 10;
 	}
 
@@ -153,6 +188,12 @@ public:
 	/// \copydoc O_Stream::operator<<(short)
 	O_Stream& operator <<(unsigned long ival);
 
+	/// \copydoc O_Stream::operator<<(short)
+	O_Stream& operator <<(long long ival);
+
+	/// \copydoc O_Stream::operator<<(short)
+	O_Stream& operator <<(unsigned long long ival);
+
 	/*! \brief Darstellung eines Zeigers als hexadezimale ganze Zahl
 	 *
 	 *  \todo Operator implementieren
@@ -175,20 +216,78 @@ public:
 	 */
 	O_Stream& operator <<(O_Stream& (*f) (O_Stream&));
 
+	/*! \name Schnittstelle für format()
+	 *
+	 *  Diese Methoden werden von den in object/format.h erzeugten Aufrufen
+	 *  verwendet; die Basis des Streams (\c base) bleibt dabei unverändert.
+	 *  \{
+	 */
+
+	/*! \brief Fügt \p len Zeichen ab \p s unverändert ein.
+	 *
+	 *  Lange Zeichenketten werden ohne Kopie an die Ausgabe übergeben
+	 *  (siehe Stringbuffer::write_span()).
+	 */
+	void append(const char *s, size_t len) {
+		put(s, len);
+	}
+
+	/*! \brief Formatiert eine Zahl gemäß \p spec.
+	 *  \param ival Betrag der Zahl
+	 *  \param negative Gibt an, ob ein Minuszeichen vorangestellt werden soll
+	 *  \param spec Basis, Präfix, Breite und Füllzeichen
+	 */
+	void put_number(unsigned int ival, bool negative, const Format_Spec &spec);
+
+	/// \copydoc O_Stream::put_number(unsigned int, bool, const Format_Spec&)
+	void put_number(unsigned long long ival, bool negative, const Format_Spec &spec);
+
+	/// Fügt \p len Zeichen ab \p s ein, aufgefüllt gemäß \p spec.
+	void put_field(const char *s, size_t len, const Format_Spec &spec) {
+		put_field(nullptr, 0, s, len, spec);
+	}
+
+	/// \}
+
 #define TIME_DISPLAY_LENGTH 25
 
     /*!
      * Darstellung der Uhrzeit und des Datums.
      * Beansprucht TIME_DISPLAY_LENGTH viele Zeichen.
      */
-    O_Stream& operator <<(Time& t);
+    O_Stream& operator <<(const Time& t);
 
     O_Stream& operator <<(String &str);
 
+    /// Gibt die Zeichen der Ansicht \p str ohne Kopie in einen String aus.
+    O_Stream& operator <<(const StringView &str);
+
     // necessary because c++
     virtual O_Stream& operator <<(CGA_Screen::Attribute& attr);
 };
 
+/*! \brief O_Stream mit eigenem Zeichenpuffer der Größe \p SIZE.
+ *
+ *  Ausgaben, deren Ziel lange Zeichenketten effizient annimmt (z.B. der
+ *  CGA-Bildschirm), können so einen größeren Puffer wählen als solche, die
+ *  nur kurze Meldungen schreiben.
+ *
+ *  \tparam SIZE Größe des Zeichenpuffers
+ */
+template <int SIZE>
+class Buffered_O_Stream : public O_Stream {
+	Buffered_O_Stream(const Buffered_O_Stream&)            = delete;
+	Buffered_O_Stream& operator=(const Buffered_O_Stream&) = delete;
+
+	static_assert(SIZE > 0, "the buffer must hold at least one character");
+
+	char storage[SIZE];
+
+protected:
+	// storage is only used by its address until the first put()
+	Buffered_O_Stream() : O_Stream(storage, SIZE) {}
+};
+
 /*! \brief Löst explizit ein Leeren (Flush) des Puffers aus.
  *
  *  \todo Modifikator implementieren
@@ -0,0 +1,67 @@
+// vim: set et ts=4 sw=4:
+
+#include "object/scrollback.h"
+
+void Scrollback::drop_oldest() {
+    unsigned size = 2 + at(tail) * sizeof(CGA_Screen::Pixel);
+    tail  = (tail + size) % SIZE;
+    used -= size;
+    count--;
+}
+
+void Scrollback::push(const CGA_Screen::Pixel *line, int width) {
+    // trailing blanks are not stored
+    while (width > 0 && line[width - 1].ascii == ' ') {
+        width--;
+    }
+    if (width > 255) {
+        width = 255;
+    }
+
+    unsigned size = 2 + width * sizeof(CGA_Screen::Pixel);
+    while (SIZE - used < size) {
+        drop_oldest();
+    }
+
+    const uint8_t *bytes = (const uint8_t *) line;
+    data[head] = width;
+    head = (head + 1) % SIZE;
+    for (unsigned i = 0; i < width * sizeof(CGA_Screen::Pixel); i++) {
+        data[head] = bytes[i];
+        head = (head + 1) % SIZE;
+    }
+    data[head] = width;
+    head = (head + 1) % SIZE;
+
+    used += size;
+    count++;
+}
+
+bool Scrollback::get(unsigned age, CGA_Screen::Pixel *line, int width,
+                     CGA_Screen::Attribute fill) const {
+    if (age == 0 || age > count) {
+        return false;
+    }
+
+    // walk backwards from the newest record
+    unsigned end = head;
+    for (;;) {
+        unsigned len  = at(end + SIZE - 1);
+        unsigned size = 2 + len * sizeof(CGA_Screen::Pixel);
+        unsigned start = (end + SIZE - size) % SIZE;
+
+        if (--age == 0) {
+            int n = ((int) len < width) ? (int) len : width;
+            uint8_t *bytes = (uint8_t *) line;
+            for (unsigned i = 0; i < n * sizeof(CGA_Screen::Pixel); i++) {
+                bytes[i] = at(start + 1 + i);
+            }
+            for (int x = n; x < width; x++) {
+                line[x] = {' ', fill};
+            }
+            return true;
+        }
+
+        end = start;
+    }
+}
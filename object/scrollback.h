@@ -0,0 +1,73 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class Scrollback
+ */
+
+#pragma once
+
+#include "types.h"
+#include "machine/cgascr.h"
+
+/*!
+ *  \def SCROLLBACK_SIZE
+ *  \brief Size of a scrollback buffer in bytes.
+ */
+#ifndef SCROLLBACK_SIZE
+#define SCROLLBACK_SIZE (16 * 1024)
+#endif
+
+/*! \brief History of the lines that were scrolled out of a CGA_Screen window.
+ *
+ *  The lines are kept in a byte ring as records of the form
+ *  `[length][Pixel...][length]`, where trailing blanks are cut off. The length
+ *  at both ends allows walking the records in both directions: forwards to
+ *  drop the oldest lines when the ring is full, backwards to show the newest
+ *  lines first.
+ */
+class Scrollback {
+    // Disallow copies and assignments.
+    Scrollback(const Scrollback&)            = delete;
+    Scrollback& operator=(const Scrollback&) = delete;
+
+    static const unsigned SIZE = SCROLLBACK_SIZE;
+
+    uint8_t data[SIZE];
+    unsigned head;  // end of the newest record
+    unsigned tail;  // start of the oldest record
+    unsigned used;  // bytes in use
+    unsigned count; // number of lines
+
+    uint8_t at(unsigned pos) const {
+        return data[pos % SIZE];
+    }
+
+    void drop_oldest();
+
+public:
+    Scrollback() : head(0), tail(0), used(0), count(0) {}
+
+    /*! \brief Appends a line.
+     *  \param line Pixels of the line
+     *  \param width Number of pixels (at most 255)
+     */
+    void push(const CGA_Screen::Pixel *line, int width);
+
+    /*! \brief Copies a stored line.
+     *
+     *  \param age 1 for the newest line, 2 for the one before and so on
+     *  \param line Buffer for \p width pixels, the part after the stored line
+     *         is filled with blanks with the attribute \p fill
+     *  \param width Width of the window
+     *  \param fill Attribute for the padding
+     *  \return false if there is no such line
+     */
+    bool get(unsigned age, CGA_Screen::Pixel *line, int width,
+             CGA_Screen::Attribute fill) const;
+
+    /*! \brief Number of stored lines.
+     */
+    unsigned lines() const {
+        return count;
+    }
+};
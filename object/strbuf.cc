@@ -4,7 +4,48 @@
 
 void Stringbuffer::put(char c) {
 	buffer[pos++] = c;
-	if (pos == 80) {
+	if (pos == size) {
 		flush();
 	}
 }
+
+void Stringbuffer::put(const char *s, size_t len) {
+	if (len > (size_t) (size - pos)) {
+		if (pos > 0) {
+			flush();
+		}
+		if (len >= (size_t) size) {
+			write_span(s, len);
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		buffer[pos + i] = s[i];
+	}
+	pos += len;
+
+	if (pos == size) {
+		flush();
+	}
+}
+
+void Stringbuffer::write_span(const char *s, size_t len) {
+	while (len > 0) {
+		size_t chunk = size - pos;
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		for (size_t i = 0; i < chunk; i++) {
+			buffer[pos + i] = s[i];
+		}
+		pos += chunk;
+		s   += chunk;
+		len -= chunk;
+
+		if (pos == size) {
+			flush();
+		}
+	}
+}
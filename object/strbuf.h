@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "types.h"
+
 /*! \brief Die Klasse Stringbuffer dient dazu, einzelne Zeichen zu längeren Texten
  *  zusammenzustellen, die dann an einem Stück verarbeitet werden können.
  *
@@ -45,16 +47,23 @@ class Stringbuffer {
 	// werden und kann dann auch public werden.
 
 protected:
-	/// Zeichenpuffer
-	char buffer[80];
+	/// Zeichenpuffer, vom Besitzer des Stringbuffers bereitgestellt
+	char * const buffer;
+	/// Größe des Zeichenpuffers
+	const int size;
 	/// Aktuelle Position im Puffer
 	int pos;
 
 	/*! \brief Konstruktor; Markiert Puffer als leer.
+	 *
+	 *  Der Speicher für den Puffer wird von der abgeleiteten Klasse
+	 *  bereitgestellt, so dass jede Ausgabe ihre eigene Puffergröße wählen
+	 *  kann (siehe Buffered_O_Stream).
+	 *
+	 *  \param buffer Zeichenpuffer mit Platz für \p size Zeichen
+	 *  \param size Größe des Zeichenpuffers
 	 */
-	Stringbuffer() {
-		pos = 0;
-	}
+	Stringbuffer(char *buffer, int size) : buffer(buffer), size(size), pos(0) {}
 
 	/*! \brief Fügt das Zeichen c in den Puffer ein.
 	 *
@@ -67,6 +76,28 @@ protected:
 	 */
 	void put(char c);
 
+	/*! \brief Fügt \p len Zeichen ab \p s in den Puffer ein.
+	 *
+	 *  Die Zeichen werden abschnittsweise kopiert, sodass die Prüfung auf
+	 *  einen vollen Puffer nur einmal pro Abschnitt statt pro Zeichen nötig ist.
+	 *  Passen die Zeichen nicht mehr in den Puffer und sind mindestens so
+	 *  viele wie der ganze Puffer fasst, wird der Puffer geleert und die
+	 *  Zeichen werden ohne Kopie an write_span() übergeben.
+	 *
+	 *  \param s Einzufügende Zeichen
+	 *  \param len Anzahl der Zeichen
+	 */
+	void put(const char *s, size_t len);
+
+	/*! \brief Gibt \p len Zeichen ab \p s direkt aus, am Puffer vorbei.
+	 *
+	 *  Der Puffer ist beim Aufruf leer. Abgeleitete Klassen, deren Ausgabe
+	 *  ganze Zeichenketten annimmt, sollten die Methode überschreiben; die
+	 *  Standardimplementierung kopiert die Zeichen abschnittsweise durch den
+	 *  Puffer.
+	 */
+	virtual void write_span(const char *s, size_t len);
+
 	/*! \brief Methode zur Ausgabe des Pufferinhalts
 	 *
 	 *  Diese Methode muss in den abgeleiteten Klassen definiert werden,
@@ -0,0 +1,27 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the class Guarded_Barrier.
+ */
+
+#include "meeting/barrier.h"
+#include "guard/secure.h"
+
+/*! \brief System call interface to Barrier: every method is protected by a
+ *  Secure object.
+ */
+class Guarded_Barrier : public Barrier {
+    // Disallow copies and assignments.
+    Guarded_Barrier(const Guarded_Barrier&)            = delete;
+    Guarded_Barrier& operator=(const Guarded_Barrier&) = delete;
+
+public:
+    explicit Guarded_Barrier(unsigned int count) : Barrier(count) {}
+
+    bool wait() {
+        Secure s;
+        return Barrier::wait();
+    }
+};
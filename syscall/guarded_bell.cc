@@ -2,8 +2,25 @@
 
 #include "syscall/guarded_bell.h"
 #include "guard/secure.h"
+#include "machine/clock.h"
 
 void Guarded_Bell::sleep(unsigned int ms) {
     Secure s;
     Bell::sleep(ms);
 }
+
+void Guarded_Bell::sleep_until(uint64_t deadline, uint32_t slack) {
+    uint64_t now = Clock::now_ns();
+    if (deadline <= now + SPIN_NS) {
+        while (Clock::now_ns() < deadline) ;
+        return;
+    }
+
+    Secure s;
+    Bell::sleep_until(deadline, slack);
+}
+
+void Guarded_Bell::sleep_us(unsigned int us) {
+    uint64_t ns = (uint64_t) us * 1000;
+    sleep_until(Clock::now_ns() + ns, slack_for(ns));
+}
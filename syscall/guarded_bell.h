@@ -34,5 +34,16 @@ public:
 	 *
 	 */
 	static void sleep(unsigned int ms);
+
+	/*! \brief Entspricht Bell::sleep_until(), wartet aber Zeitpunkte, die
+	 *  weniger als Bell::SPIN_NS entfernt sind, aktiv ab, ohne die
+	 *  Epilogebene zu betreten.
+	 */
+	static void sleep_until(uint64_t deadline, uint32_t slack = 0);
+
+	/*! \brief Entspricht Bell::sleep_us(), mit derselben Ausnahme für sehr
+	 *  kurze Wartezeiten wie sleep_until().
+	 */
+	static void sleep_us(unsigned int us);
 };
 
@@ -0,0 +1,48 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the class template Guarded_Channel.
+ */
+
+#include "meeting/channel.h"
+#include "guard/secure.h"
+
+/*! \brief System call interface to Channel: every method is protected by a
+ *  Secure object.
+ */
+template <typename T, unsigned N>
+class Guarded_Channel : public Channel<T, N> {
+    // Disallow copies and assignments.
+    Guarded_Channel(const Guarded_Channel&)            = delete;
+    Guarded_Channel& operator=(const Guarded_Channel&) = delete;
+
+public:
+    Guarded_Channel() {}
+
+    void send(const T &val) {
+        Secure s;
+        Channel<T, N>::send(val);
+    }
+
+    bool try_send(const T &val) {
+        Secure s;
+        return Channel<T, N>::try_send(val);
+    }
+
+    void recv(T &val) {
+        Secure s;
+        Channel<T, N>::recv(val);
+    }
+
+    bool try_recv(T &val) {
+        Secure s;
+        return Channel<T, N>::try_recv(val);
+    }
+
+    bool recv(T &val, unsigned int ms) {
+        Secure s;
+        return Channel<T, N>::recv(val, ms);
+    }
+};
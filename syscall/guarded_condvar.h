@@ -0,0 +1,41 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the class Guarded_ConditionVariable.
+ */
+
+#include "meeting/condvar.h"
+#include "guard/secure.h"
+
+/*! \brief System call interface to ConditionVariable: every method is
+ *  protected by a Secure object.
+ *
+ *  wait() takes the Guarded_Mutex protecting the condition; inside the
+ *  guard, it is released and locked again through the unguarded Mutex
+ *  methods.
+ */
+class Guarded_ConditionVariable : public ConditionVariable {
+    // Disallow copies and assignments.
+    Guarded_ConditionVariable(const Guarded_ConditionVariable&)            = delete;
+    Guarded_ConditionVariable& operator=(const Guarded_ConditionVariable&) = delete;
+
+public:
+    Guarded_ConditionVariable() {}
+
+    void wait(Mutex &m) {
+        Secure s;
+        ConditionVariable::wait(m);
+    }
+
+    void notify_one() {
+        Secure s;
+        ConditionVariable::notify_one();
+    }
+
+    void notify_all() {
+        Secure s;
+        ConditionVariable::notify_all();
+    }
+};
@@ -10,6 +10,11 @@ Key Guarded_Keyboard::getkey() {
     return Keyboard::getkey();
 }
 
+Key Guarded_Keyboard::getkey(unsigned int ms) {
+    Secure s;
+    return Keyboard::getkey(ms);
+}
+
 Guarded_Keyboard& Guarded_Keyboard::operator >>(char &c) {
     Secure s;
     Keyboard::operator>>(c);
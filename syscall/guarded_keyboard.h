@@ -28,6 +28,7 @@ public:
 	 *
 	 */
 	Key getkey();
+	Key getkey(unsigned int ms);
 
     Guarded_Keyboard& operator >>(char &c);
     Guarded_Keyboard& operator >>(String &s);
@@ -6,6 +6,11 @@ void Guarded_Mutex::lock() {
     Mutex::lock();
 }
 
+bool Guarded_Mutex::try_lock_for(unsigned int ms) {
+    Secure s;
+    return Mutex::try_lock_for(ms);
+}
+
 bool Guarded_Mutex::unlock() {
     Secure s;
     return Mutex::unlock();
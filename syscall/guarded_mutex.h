@@ -6,5 +6,6 @@
 class Guarded_Mutex : public Mutex {
 public:
     void lock();
+    bool try_lock_for(unsigned int ms);
     bool unlock();
 };
@@ -0,0 +1,91 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the classes Guarded_Pipe and Pipe_Stream.
+ */
+
+#include "meeting/pipe.h"
+#include "guard/secure.h"
+#include "object/o_stream.h"
+
+/*! \brief System call interface to Pipe: every method is protected by a
+ *  Secure object.
+ */
+class Guarded_Pipe : public Pipe {
+    // Disallow copies and assignments.
+    Guarded_Pipe(const Guarded_Pipe&)            = delete;
+    Guarded_Pipe& operator=(const Guarded_Pipe&) = delete;
+
+public:
+    Guarded_Pipe() {}
+
+    size_t write(const char *text, size_t len) {
+        Secure s;
+        return Pipe::write(text, len);
+    }
+
+    size_t read(char *buf, size_t len) {
+        Secure s;
+        return Pipe::read(buf, len);
+    }
+
+    void close_write() {
+        Secure s;
+        Pipe::close_write();
+    }
+
+    void close_read() {
+        Secure s;
+        Pipe::close_read();
+    }
+};
+
+/*! \brief Output stream writing into a Guarded_Pipe.
+ *
+ *  Every flush() hands the buffered text to the pipe in one piece, and long
+ *  spans bypass the buffer. Colors are dropped.
+ *
+ *  Once the reading side has closed the pipe, writes come back short: the
+ *  stream then reports closed() and drops all further output, so a producer
+ *  can stop instead of formatting text nobody reads.
+ */
+class Pipe_Stream : public Buffered_O_Stream<80> {
+    // Disallow copies and assignments.
+    Pipe_Stream(const Pipe_Stream&)            = delete;
+    Pipe_Stream& operator=(const Pipe_Stream&) = delete;
+
+    Guarded_Pipe &pipe;
+    bool gone;
+
+    void write(const char *s, size_t len) {
+        if (!gone && pipe.write(s, len) < len) {
+            gone = true;
+        }
+    }
+
+public:
+    explicit Pipe_Stream(Guarded_Pipe &pipe) : pipe(pipe), gone(false) {}
+
+    void flush() override {
+        write(buffer, pos);
+        pos = 0;
+    }
+
+    void write_span(const char *s, size_t len) override {
+        write(s, len);
+    }
+
+    //! \brief true once output was lost because the reader is gone.
+    bool closed() const {
+        return gone;
+    }
+
+    using O_Stream::operator<<;
+
+    O_Stream& operator <<(CGA_Screen::Attribute& attr) override {
+        (void) attr;
+        return *this;
+    }
+};
@@ -0,0 +1,42 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the class Guarded_RWLock.
+ */
+
+#include "meeting/rwlock.h"
+#include "guard/secure.h"
+
+/*! \brief System call interface to RWLock: every method is protected by a
+ *  Secure object.
+ */
+class Guarded_RWLock : public RWLock {
+    // Disallow copies and assignments.
+    Guarded_RWLock(const Guarded_RWLock&)            = delete;
+    Guarded_RWLock& operator=(const Guarded_RWLock&) = delete;
+
+public:
+    Guarded_RWLock() {}
+
+    void read_lock() {
+        Secure s;
+        RWLock::read_lock();
+    }
+
+    void read_unlock() {
+        Secure s;
+        RWLock::read_unlock();
+    }
+
+    void write_lock() {
+        Secure s;
+        RWLock::write_lock();
+    }
+
+    void write_unlock() {
+        Secure s;
+        RWLock::write_unlock();
+    }
+};
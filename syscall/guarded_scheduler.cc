@@ -1,22 +1,38 @@
 #include "syscall/guarded_scheduler.h"
 #include "guard/secure.h"
-#include "user/status/status.h"
 
-void Guarded_Scheduler::exit() {
+void Guarded_Scheduler::exit(int code) {
     Secure s;
-    status.thread_dec();
-    scheduler.exit();
+    scheduler.exit(code);
 }
 
-void Guarded_Scheduler::kill(Thread *that) {
+bool Guarded_Scheduler::kill(Thread *that) {
     Secure s;
-    status.thread_dec();
+    // killing a thread that has already exited does nothing.
+    if (that->dead()) {
+        return false;
+    }
     scheduler.kill(that);
+    return true;
+}
+
+int Guarded_Scheduler::join(Thread *that) {
+    Secure s;
+    return scheduler.join(that);
+}
+
+void Guarded_Scheduler::detach(Thread *that) {
+    Secure s;
+    scheduler.detach(that);
+}
+
+bool Guarded_Scheduler::dead(Thread *that) {
+    Secure s;
+    return that->dead();
 }
 
 void Guarded_Scheduler::ready(Thread *that) {
     Secure s;
-    status.thread_inc();
     scheduler.ready(that);
 }
 
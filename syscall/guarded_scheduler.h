@@ -19,9 +19,20 @@
  */
 class Guarded_Scheduler {
 public:
-    static void exit();
+    static void exit(int code = 0);
 
-    static void kill(Thread *that);
+    // false if "that" had already exited
+    static bool kill(Thread *that);
+
+    // waits until "that" is dead and returns its exit code; "that" may be
+    // deleted afterwards.
+    static int join(Thread *that);
+
+    // lets the scheduler delete "that" once it is dead.
+    static void detach(Thread *that);
+
+    // true once "that" has exited or been killed.
+    static bool dead(Thread *that);
 
     static void ready(Thread *that);
 
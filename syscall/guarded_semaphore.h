@@ -45,6 +45,12 @@ public:
         Semaphore::p();
 	}
 
+	/// \copydoc Semaphore::p_timeout()
+	bool p_timeout(unsigned int ms) {
+        Secure s;
+        return Semaphore::p_timeout(ms);
+	}
+
 	/// \copydoc p()
 	void v() {
         Secure s;
@@ -0,0 +1,44 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+/*! \file
+ *  \brief Contains the class Guarded_Timer.
+ */
+
+#include "meeting/timer.h"
+#include "guard/secure.h"
+
+/*! \brief System call interface to Timer: every method is protected by a
+ *  Secure object.
+ *
+ *  Only starting and stopping the timer needs that; the callback itself
+ *  always runs at epilogue level.
+ */
+class Guarded_Timer : public Timer {
+    // Disallow copies and assignments.
+    Guarded_Timer(const Guarded_Timer&)            = delete;
+    Guarded_Timer& operator=(const Guarded_Timer&) = delete;
+
+public:
+    Guarded_Timer(void (*callback)(void *), void *arg = nullptr) : Timer(callback, arg) {}
+
+    ~Guarded_Timer() {
+        cancel();
+    }
+
+    void start(unsigned int ms, unsigned int period = 0) {
+        Secure s;
+        Timer::start(ms, period);
+    }
+
+    void start_us(unsigned int us, unsigned int period = 0) {
+        Secure s;
+        Timer::start_us(us, period);
+    }
+
+    void cancel() {
+        Secure s;
+        Timer::cancel();
+    }
+};
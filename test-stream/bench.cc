@@ -0,0 +1,72 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Throughput benchmark for the number formatting of O_Stream.
+ *
+ *  The stream discards its buffer on flush(), so the measured time is the
+ *  formatting and buffering alone.
+ */
+
+#include "o_stream.h"
+#include <stdio.h>
+#include <time.h>
+
+class NullOut : public Buffered_O_Stream<80> {
+    NullOut(const NullOut&)            = delete;
+    NullOut& operator=(const NullOut&) = delete;
+
+public:
+    unsigned long long bytes;
+
+    NullOut() : bytes(0) {}
+
+    virtual void flush() {
+        bytes += pos;
+        pos = 0;
+    }
+};
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+template <typename T>
+static void run(const char *name, O_Stream& (*base)(O_Stream&), T start, T step) {
+    const unsigned N = 5000000;
+    NullOut out;
+    out << base;
+
+    double t = now();
+    T v = start;
+    for (unsigned i = 0; i < N; i++) {
+        out << v << ' ';
+        v = (T) ((unsigned long long) v + step); // wraps without signed overflow
+    }
+    out.flush();
+    t = now() - t;
+
+    printf("%-20s %8.1f ns/number %8.1f MB/s\n", name, t * 1e9 / N, out.bytes / t / 1e6);
+}
+
+int main() {
+    run<int>("int dec", dec, -1000000, 7919);
+    run<unsigned int>("uint dec small", dec, 0, 1);
+    run<unsigned int>("uint hex", hex, 0, 2654435761u);
+    run<unsigned int>("uint bin", bin, 0, 2654435761u);
+    run<long long>("int64 dec", dec, -4000000000000000000ll, 1600000000000ll);
+    run<unsigned long long>("uint64 hex", hex, 0, 11400714819323198485ull);
+
+    NullOut out;
+    const unsigned N = 5000000;
+    double t = now();
+    for (unsigned i = 0; i < N; i++) {
+        out << "a string of some length\n";
+    }
+    out.flush();
+    t = now() - t;
+    printf("%-20s %8.1f ns/string %8.1f MB/s\n", "string", t * 1e9 / N, out.bytes / t / 1e6);
+
+    return 0;
+}
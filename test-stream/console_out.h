@@ -14,7 +14,7 @@
  *  Die Klasse ConsoleOut ermöglicht ein Schreiben auf der Konsole ähnlich std::cout
  *  aus der C++-Standardsbibliothek. Die Klasse ist von O_Stream abgeleitet.
  */
-class ConsoleOut : public O_Stream
+class ConsoleOut : public Buffered_O_Stream<80>
 {
 	// Verhindere Kopien und Zuweisungen
 	ConsoleOut(const ConsoleOut&)            = delete;
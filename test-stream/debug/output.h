@@ -0,0 +1,13 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Host replacement for the kernel's debug/output.h: debug output is
+ *  discarded.
+ */
+
+#pragma once
+
+#include "debug/null_stream.h"
+
+#define DBG nullstream
+#define DBG_VERBOSE nullstream
@@ -18,7 +18,7 @@
  *  zu Hilfenahme der elementaren Systemaufrufe `open()` / `write()` / `close()` .
  *  Diese Klasse ist von O_Stream abgeleitet.
  */
-class FileOut : public O_Stream
+class FileOut : public Buffered_O_Stream<80>
 {
 	// Verhindere Kopien und Zuweisungen
 	FileOut(const FileOut&)            = delete;
@@ -1,5 +1,6 @@
 #include "console_out.h"
 #include "file_out.h"
+#include "format.h"
 
 ConsoleOut cout;
 FileOut foo("foo.txt");
@@ -19,6 +20,54 @@ int main(){
     cout << "   octal: " << oct << -1 << dec << " -> 037777777777" << endl;
     cout << "   hex: " << hex << -1 << dec << " -> 0xffffffff" << endl;
 	cout << "   pointer: " << ((void*)(3735928559u)) << " -> 0xdeadbeef" << endl;
+	cout << "   uint64 max: " << ~0ull << " -> 18446744073709551615" << endl;
+	cout << "   int64 min: " << (-9223372036854775807ll - 1) << " -> -9223372036854775808" << endl;
+	cout << "   some int64: " << 1234567890123456789ll << " -> 1234567890123456789" << endl;
+	cout << "   small int64: " << 1000000000000000000ll << " -> 1000000000000000000" << endl;
+	cout << "   hex int64: " << hex << 0x123456789abcdefull << dec << " -> 0x123456789abcdef" << endl;
+	cout << "   base 3: ";
+	cout.base = 3;
+	cout << 8 << dec << " -> 22" << endl;
+	cout << endl;
+
+	cout << "Format Test <format result> -> <expected>" << endl;
+	format(cout, FMT("   plain: {} {} {} -> 42 -7 text\n"), 42, -7, "text");
+	format(cout, FMT("   width: [{:5}] [{:<5}] [{:*>5}] -> [   42] [42   ] [***42]\n"), 42, 42, 42);
+	format(cout, FMT("   zero fill: {:08x} {:04} -> 0000beef -042\n"), 0xbeef, -42);
+	format(cout, FMT("   prefix: {:#x} {:#010x} {:#o} {:#b} -> 0x2a 0x0000002a 052 0b101010\n"), 42, 42, 42, 42);
+	format(cout, FMT("   hex: {:x} {:x} -> ffffffff ffffffffffffffff\n"), -1, -1ll);
+	format(cout, FMT("   int64: {:>20} -> \" 1234567890123456789\"\n"), 1234567890123456789ull);
+	format(cout, FMT("   strings: [{:-<6}] [{:>6}] -> [ab----] [  true]\n"), "ab", true);
+	format(cout, FMT("   pointer: {} -> 0xdeadbeef\n"), (void *) 3735928559u);
+	format(cout, FMT("   escapes: {{{}}} -> {{1}}\n"), 1);
+	cout << "   base unchanged: " << hex;
+	format(cout, FMT("{} "), 42);
+	cout << 42 << dec << " -> 42 0x2a" << endl;
+	cout << endl;
+
+	cout << "String Test <result> -> <expected>" << endl;
+	{
+		String line("  set  time 12:34 ");
+		StringView args(line);
+		StringView cmd = args.tok(" ");
+		StringView sub = args.tok(" ");
+		StringView hour = args.tok(" :");
+		StringView minute = args.tok(" :");
+		cout << "   tok: [" << cmd << "] [" << sub << "] [" << hour << "] [" << minute << "] ["
+		     << args.tok(" ") << "] -> [set] [time] [12] [34] []" << endl;
+		cout << "   streq: " << streq(cmd, "set") << ' ' << streq(sub, "times")
+		     << " -> true false" << endl;
+		cout << "   strtol: " << strtol(hour) * 60 + strtol(minute) << " -> 754" << endl;
+		StringView first = strtok(line, " ");
+		StringView second = line.tok(" ");
+		cout << "   strtok: [" << first << "] [" << second << "] -> [set] [time]" << endl;
+
+		String moved(static_cast<String&&>(line));
+		cout << "   move: [" << moved << "] [" << line << "] -> [  set  time 12:34 ] []" << endl;
+		line = String("a string that does not fit into the short buffer");
+		moved = static_cast<String&&>(line);
+		cout << "   move assignment: " << moved.length() << ' ' << line.length() << " -> 48 0" << endl;
+	}
 	cout << endl;
 
 	cout << "File Test" << endl
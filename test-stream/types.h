@@ -0,0 +1,14 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Host replacement for the kernel's types.h, so that the stream
+ *  classes can be built and run as a normal program.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <limits.h>
+#include <assert.h>
@@ -0,0 +1,162 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Checks the string functions of user/string against glibc and
+ *  compares their speed.
+ *
+ *  All results are compared with the glibc versions first (on every
+ *  alignment and on texts with many near matches), then both are timed on
+ *  the same inputs.
+ */
+
+#include "user/string/string.h"
+#include <stdio.h>
+#include <time.h>
+
+size_t libc_strlen(const char *s);
+const char *libc_memchr(const char *s, char c, size_t len);
+int libc_compare(const char *a, size_t a_len, const char *b, size_t b_len);
+const char *libc_memmem(const char *haystack, size_t len, const char *needle, size_t needle_len);
+size_t libc_strcspn(const char *s, const char *reject);
+
+static const size_t TEXT_SIZE = 64 * 1024;
+static char text[TEXT_SIZE + 64];
+static char other[TEXT_SIZE + 64];
+
+static unsigned failures = 0;
+
+static void check(bool ok, const char *what, size_t a, size_t b) {
+    if (!ok && failures++ < 10) {
+        printf("FAIL %s (%zu, %zu)\n", what, a, b);
+    }
+}
+
+static unsigned random_state = 12345;
+
+static unsigned next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// fills "buf" with chars from "alphabet"; a small alphabet gives many near matches
+static void fill(char *buf, size_t len, const char *alphabet) {
+    size_t n = libc_strlen(alphabet);
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = alphabet[next_random() % n];
+    }
+    buf[len] = '\0';
+}
+
+static int sign(int x) {
+    return (x > 0) - (x < 0);
+}
+
+static void test() {
+    fill(text, TEXT_SIZE, "abcdefghijklmnopqrstuvwxyz");
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t len = 0; len < 100; len++) {
+            char saved = text[offset + len];
+            text[offset + len] = '\0';
+            check(strlen(text + offset) == libc_strlen(text + offset), "strlen", offset, len);
+            text[offset + len] = saved;
+        }
+    }
+
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t len = 0; len < 100; len++) {
+            char c = 'a' + next_random() % 26;
+            check(memchr(text + offset, c, len) == libc_memchr(text + offset, c, len),
+                  "memchr", offset, len);
+        }
+    }
+
+    for (unsigned i = 0; i < 10000; i++) {
+        size_t a_len = next_random() % 40, b_len = next_random() % 40;
+        fill(text, a_len, "ab");
+        fill(other + i % 8, b_len, "ab");
+        check(sign(strcmp(StringView(text, a_len), StringView(other + i % 8, b_len)))
+              == sign(libc_compare(text, a_len, other + i % 8, b_len)), "strcmp", a_len, b_len);
+    }
+
+    fill(text, TEXT_SIZE, "aab");
+    for (unsigned i = 0; i < 10000; i++) {
+        size_t needle_len = next_random() % 300;
+        size_t start = next_random() % (TEXT_SIZE - needle_len);
+        const char *needle = (i % 2) ? text + start : other;
+        if (!(i % 2)) {
+            fill(other, needle_len, "aab");
+        }
+
+        size_t pos = next_random() % 1000;
+        size_t found = StringView(text, TEXT_SIZE).find(StringView(needle, needle_len), pos);
+        const char *ref = libc_memmem(text + pos, TEXT_SIZE - pos, needle, needle_len);
+        check(found == (ref ? (size_t) (ref - text) : StringView::npos), "find", pos, needle_len);
+    }
+
+    fill(text, 4096, "abcdefghijklmnopqrstuvwxyz");
+    for (unsigned i = 0; i < 1000; i++) {
+        fill(other, 1 + next_random() % 4, "abcdefghijklmnopqrstuvwxyz");
+        size_t found = StringView(text, 4096).find_first_of(StringView(other));
+        size_t ref = libc_strcspn(text, other);
+        check(found == (ref == 4096 ? StringView::npos : ref), "find_first_of", i, ref);
+    }
+
+    printf("%s\n", failures ? "string tests FAILED" : "string tests passed");
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// the volatile sink keeps the compiler from dropping the calls
+static volatile size_t sink;
+
+#define TIME(NAME, BYTES, EXPR) do { \
+        const unsigned N = 20000; \
+        double t = now(); \
+        for (unsigned i = 0; i < N; i++) { \
+            sink = (size_t) (EXPR); \
+        } \
+        t = now() - t; \
+        printf("%-28s %8.1f ns/call %8.1f MB/s\n", NAME, t * 1e9 / N, (double) (BYTES) * N / t / 1e6); \
+    } while (0)
+
+static void bench() {
+    const size_t len = 4096;
+    fill(text, len, "abcdefghijklmnopqrstuvwxyz");
+    for (size_t i = 0; i < len; i++) {
+        other[i] = text[i];
+    }
+    other[len] = '\0';
+
+    TIME("strlen",                len, strlen(text));
+    TIME("strlen (glibc)",        len, libc_strlen(text));
+    TIME("memchr",                len, memchr(text, '!', len));
+    TIME("memchr (glibc)",        len, libc_memchr(text, '!', len));
+    TIME("strcmp equal",          len, strcmp(StringView(text, len), StringView(other, len)));
+    TIME("memcmp equal (glibc)",  len, libc_compare(text, len, other, len));
+    TIME("find_first_of 3",       len, StringView(text, len).find_first_of(" \t\n"));
+    TIME("strcspn 3 (glibc)",     len, libc_strcspn(text, " \t\n"));
+
+    fill(text, TEXT_SIZE, "abcdefghijklmnopqrstuvwxyz");
+    const char needle[] = "missing needle";
+    const size_t needle_len = sizeof(needle) - 1;
+    TIME("find 14",               TEXT_SIZE, StringView(text, TEXT_SIZE).find(needle));
+    TIME("memmem 14 (glibc)",     TEXT_SIZE, libc_memmem(text, TEXT_SIZE, needle, needle_len));
+
+    fill(text, TEXT_SIZE, "ab");
+    const char near[] = "abababababababbb";
+    const size_t near_len = sizeof(near) - 1;
+    TIME("find 16, alphabet 2",   TEXT_SIZE, StringView(text, TEXT_SIZE).find(near));
+    TIME("memmem 16, alphabet 2 (glibc)", TEXT_SIZE, libc_memmem(text, TEXT_SIZE, near, near_len));
+}
+
+int main() {
+    test();
+    bench();
+    return failures != 0;
+}
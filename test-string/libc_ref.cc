@@ -0,0 +1,39 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief glibc versions of the string functions, as a reference for
+ *  bench.cc.
+ *
+ *  They live in their own file, because the kernel's string.h declares
+ *  functions of the same names as <string.h>.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memmem
+#endif
+#include <string.h>
+
+size_t libc_strlen(const char *s) {
+    return strlen(s);
+}
+
+const char *libc_memchr(const char *s, char c, size_t len) {
+    return (const char *) memchr(s, c, len);
+}
+
+int libc_compare(const char *a, size_t a_len, const char *b, size_t b_len) {
+    int res = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (res != 0 || a_len == b_len) {
+        return res;
+    }
+    return a_len > b_len ? 1 : -1;
+}
+
+const char *libc_memmem(const char *haystack, size_t len, const char *needle, size_t needle_len) {
+    return (const char *) memmem(haystack, len, needle, needle_len);
+}
+
+// "s" has to be null-terminated
+size_t libc_strcspn(const char *s, const char *reject) {
+    return strcspn(s, reject);
+}
@@ -1,9 +1,10 @@
 // vim: set et ts=4 sw=4:
 
 #include "thread/dispatcher.h"
-#include "debug/output.h"
+#include "debug/log.h"
 #include "guard/guard.h"
 #include "machine/cpu.h"
+#include "debug/trace.h"
 
 Thread *Dispatcher::active() {
     return life[system.getCPUID()];
@@ -11,14 +12,16 @@ Thread *Dispatcher::active() {
 
 void Dispatcher::go(Thread *first) {
     if (active() != nullptr) {
-        DBG << "Dispatcher: invalid go" << endl;
+        LOG_ERROR << "Dispatcher: invalid go" << endl;
     }
+    TRACE_EVENT(context_switch, first);
     set_active(first);
     first->go();
 }
 
 void Dispatcher::dispatch(Thread *next) {
     Thread *prev = active();
+    TRACE_EVENT(context_switch, next);
     set_active(next);
     prev->resume(next);
 }
@@ -33,7 +33,10 @@ protected:
     Thread *life[CPU_MAX];
 
 	void set_active(Thread *c) {
-        life[system.getCPUID()] = c;
+        int cpu = system.getCPUID();
+        life[cpu] = c;
+        c->run_state = Thread::RUNNING;
+        c->cpu = cpu;
     }
 
 public:
@@ -11,7 +11,11 @@ void IdleThread::action() {
         CPU::disable_int();
         if (scheduler.is_empty()) {
             status.set_idle(true);
-            if (!bellringer.bell_pending() || system.getCPUID() != 0) {
+            // the timer must keep running for bells on this CPU; the
+            // millisecond bells are checked on CPU 0 only.
+            bool bells = bellringer.hires_pending()
+                         || (system.getCPUID() == 0 && bellringer.bell_pending());
+            if (!bells) {
                 watch.block();
                 CPU::idle();
                 watch.unblock();
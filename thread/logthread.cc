@@ -0,0 +1,13 @@
+// vim: set et ts=4 sw=4:
+
+#include "thread/logthread.h"
+#include "debug/log.h"
+#include "syscall/guarded_bell.h"
+
+void LogThread::action() {
+    for (;;) {
+        if (!klog.drain()) {
+            Guarded_Bell::sleep(INTERVAL);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the class LogThread
+ */
+
+#pragma once
+
+#include "thread/thread.h"
+
+/*! \brief Thread that prints the records of the kernel log (see debug/log.h).
+ *  \ingroup thread
+ *
+ *  When there is nothing to print, it sleeps for LogThread::INTERVAL
+ *  milliseconds, so it only competes with other threads while there is
+ *  output pending.
+ */
+class LogThread : public Thread {
+    // Disallow copies and assignments.
+    LogThread(const LogThread&)            = delete;
+    LogThread& operator=(const LogThread&) = delete;
+
+public:
+    static const unsigned int INTERVAL = 20;
+
+    LogThread() : Thread() {}
+
+    void action() override;
+};
@@ -3,11 +3,13 @@
 #include "thread/scheduler.h"
 #include "guard/guard.h"
 #include "guard/secure.h"
-#include "debug/output.h"
+#include "debug/log.h"
 #include "machine/plugbox.h"
 #include "machine/cpu.h"
 #include "user/status/status.h"
 #include "meeting/bellringer.h"
+#include "meeting/timeout.h"
+#include "debug/trace.h"
 
 Scheduler scheduler;
 
@@ -20,65 +22,121 @@ void Scheduler::schedule() {
 }
 
 void Scheduler::ready(Thread *that) {
+    TRACE_EVENT(ready, that);
+    if (that->run_state == Thread::NEW) {
+        status.thread_inc();
+    }
+    that->run_state = Thread::READY;
     ready_list.enqueue(that);
     system.sendCustomIPI((1 << system.getNumberOfOnlineCPUs()) - 1, Plugbox::Vector::wakeup);
 }
 
-void Scheduler::exit() {
-    active()->Thread::~Thread();
+void Scheduler::finish(Thread *that, int code) {
+    if (that->run_state != Thread::NEW) {
+        status.thread_dec();
+    }
+    that->run_state = Thread::ZOMBIE;
+    that->exit_status = code;
+    that->mutex_release_all();
+    that->rwlock_release_all();
+
+    // the timeout lives on the stack, which is freed with the thread.
+    if (Timeout *t = that->wait_timeout()) {
+        t->cancel();
+    }
+
+    while (Thread *t = that->joiners.first()) {
+        wakeup(t);
+    }
+
+    // the stack is still in use until the next thread runs on this CPU,
+    // which is after the guard has been left: reap() takes the zombies
+    // inside the guard.
+    if (that->detached) {
+        zombies.enqueue(that);
+        workqueue.submit(&reaper);
+    }
+}
+
+void Scheduler::reap(void *) {
+    for (;;) {
+        Thread *t;
+        {
+            Secure s;
+            t = scheduler.zombies.dequeue();
+        }
+        if (t == nullptr) {
+            break;
+        }
+        delete t;
+    }
+}
+
+void Scheduler::exit(int code) {
+    Thread *t = active();
+    finish(t, t->dying() ? Thread::KILLED : code);
     dispatch_next();
 }
 
 void Scheduler::kill(Thread *that) {
-    // check ready_list for "that"
-    if (ready_list.remove(that) != 0) {
-        DBG << "Scheduler: kill: was in ready_list" << endl;
-        that->Thread::~Thread();
+    switch (that->run_state) {
+    case Thread::NEW:
+        break;
+
+    case Thread::READY:
+        LOG_DEBUG << "Scheduler: kill: was in ready_list" << endl;
+        ready_list.remove(that);
+        break;
+
+    case Thread::BLOCKED:
+        LOG_DEBUG << "Scheduler: kill: was in waitingroom" << endl;
+        that->waiting_in()->remove(that);
+        that->waiting_in(nullptr);
+        break;
+
+    case Thread::RUNNING:
+        if (that->cpu == system.getCPUID()) {
+            exit(Thread::KILLED);
+            return;
+        }
+        // resume(), block() or the assassin on that CPU finish it off.
+        that->set_kill_flag();
+        LOG_DEBUG << "Scheduler: kill: IPI to " << that->cpu << endl;
+        system.sendCustomIPI(system.getLogicalLAPICID(that->cpu), Plugbox::Vector::assassin);
         return;
-    }
 
-    // check if "that" is in a waitingroom
-    if (Waitingroom *w = that->waiting_in()) {
-        DBG << "Scheduler: kill: was in waitingroom" << endl;
-        w->remove(that);
-        //that->waiting_in(nullptr);
-        that->Thread::~Thread();
+    case Thread::ZOMBIE:
         return;
     }
+    finish(that, Thread::KILLED);
+}
 
-    // otherwise, set kill flag and send IPI to the correct CPU
-    that->set_kill_flag();
-
-    // find the CPU that is currently executing "that"
-    uint8_t dest = 255;
-    for (unsigned int i = 0; i < sizeof(life) / sizeof(life[0]); i++) {
-        if (life[i] == that) {
-            dest = i;
-            break;
-        }
+int Scheduler::join(Thread *that) {
+    while (that->run_state != Thread::ZOMBIE) {
+        block(&that->joiners);
     }
-    if (dest == 255) {
-        DBG << "Scheduler: kill: you fucked up" << endl;
+    return that->exit_status;
+}
+
+void Scheduler::detach(Thread *that) {
+    if (that->detached) {
         return;
     }
-
-    if (dest == system.getCPUID()) {
-        that->Thread::~Thread();
-        dispatch_next();
-    } else {
-        DBG << "Scheduler: kill: IPI to " << (int) dest << endl;
-        system.sendCustomIPI(system.getLogicalLAPICID(dest), Plugbox::Vector::assassin);
+    that->detached = true;
+    if (that->run_state == Thread::ZOMBIE) {
+        zombies.enqueue(that);
+        workqueue.submit(&reaper);
     }
 }
 
 void Scheduler::resume() {
     Thread *prev = active();
     if (prev->dying()) {
-        //prev->reset_kill_flag();
-        prev->Thread::~Thread();
+        finish(prev, Thread::KILLED);
     } else {
         // dont queue idlethreads! but update the status correctly.
         if (prev != idlethread[system.getCPUID()]) {
+            prev->run_state = Thread::READY;
             ready_list.enqueue(prev);
         } else {
             status.set_idle(false);
@@ -90,6 +148,16 @@ void Scheduler::resume() {
 
 void Scheduler::block(Waitingroom *w) {
     Thread *t = active();
+    if (t->dying()) {
+        // the kill came in while the thread was on its way here. The caller
+        // may already have set up its wait (a Channel waiter, a timeout),
+        // which remove() takes down as for a thread that was in the room.
+        w->remove(t);
+        exit(Thread::KILLED);
+        return;
+    }
+    TRACE_EVENT(block, t);
+    t->run_state = Thread::BLOCKED;
     w->enqueue(t);
     t->waiting_in(w);
     dispatch_next();
@@ -104,7 +172,22 @@ void Scheduler::set_idle_thread(int cpuid, Thread *thread) {
 }
 
 void Scheduler::wakeup(Thread *customer) {
+    TRACE_EVENT(wakeup, customer);
     customer->waiting_in()->remove(customer);
     customer->waiting_in(nullptr);
     ready(customer);
 }
+
+void Scheduler::handoff(Thread *customer) {
+    Thread *prev = active();
+    if (prev == idlethread[system.getCPUID()] || prev->dying()) {
+        wakeup(customer);
+        return;
+    }
+
+    TRACE_EVENT(wakeup, customer);
+    customer->waiting_in()->remove(customer);
+    customer->waiting_in(nullptr);
+    ready(prev);
+    dispatch(customer);
+}
@@ -9,7 +9,8 @@
 
 #include "thread/dispatcher.h"
 #include "thread/thread.h"
-#include "object/queue.h"
+#include "thread/workqueue.h"
+#include "object/list.h"
 
 /*! \brief Der Scheduler implementiert die Ablaufplanung und somit die Auswahl des nächsten Threads.
  *  \ingroup thread
@@ -19,7 +20,12 @@
  *  Klasse), also die Liste der lauffähigen Threads. Die
  *  Liste wird von vorne nach hinten abgearbeitet. Dabei werden Threads, die
  *  neu im System sind oder den Prozessor abgeben, stets an das Ende der Liste
- *  angefügt.
+ *  angefügt. Die Ready-Liste ist doppelt verkettet, damit kill() einen
+ *  Thread in konstanter Zeit aus ihr entfernen kann.
+ *
+ *  Jeder Thread hat einen Zustand (Thread::State), den nur der Scheduler
+ *  ändert: NEW bis zum ersten ready(), dann READY, RUNNING oder BLOCKED, und
+ *  schließlich ZOMBIE, sobald er sich beendet hat oder beendet wurde.
  */
 class Scheduler
 	: public Dispatcher
@@ -28,16 +34,27 @@ class Scheduler
 	Scheduler(const Scheduler&)            = delete;
 	Scheduler& operator=(const Scheduler&) = delete;
 
-    Queue<Thread> ready_list;
+    List<Thread> ready_list;
     Thread *idlethread[CPU_MAX];
 
+    // detached threads that are done, deleted by reap()
+    List<Thread> zombies;
+    Work reaper;
+
     void dispatch_next();
 
+    // macht "that" zum Zombie, weckt die auf ihn wartenden Threads und gibt
+    // ihn, falls er abgekoppelt ist, zum Löschen frei.
+    void finish(Thread *that, int code);
+
+    // löscht die Zombies, auf Thread-Ebene (siehe workqueue)
+    static void reap(void *);
+
 public:
 	/*! \brief Konstruktor
 	 *
 	 */
-	Scheduler() {}
+	Scheduler() : reaper(reap) {}
 
 	/*! \brief Starten des Schedulings
 	 *
@@ -68,10 +85,9 @@ public:
 	 *  an das Ende der Ready-Liste angefügt. Statt dessen wird nur der erste
 	 *  Thread von der Ready-Liste heruntergenommen und aktiviert.
 	 *
-	 *  \todo Methode implementieren
-	 *
+	 *  \param code Exit-Code, den join() liefert.
 	 */
-	void exit();
+	void exit(int code = 0);
 
 	/*! \brief Beenden eines beliebigen Threads
 	 *
@@ -84,12 +100,30 @@ public:
 	 *  bei ihm vermerkt werden, dass der
 	 *  Thread beendet werden soll. Dies muss in resume überprüft werden,
 	 *  bevor ein Thread wieder in die Ready-Liste eingetragen wird.
+	 *
+	 *  Dank des Threadzustands kostet das keine Suche: ein bereiter Thread
+	 *  wird aus der Ready-Liste ausgekettet, ein wartender aus seinem
+	 *  Waitingroom, und ein laufender bekommt einen IPI an seine CPU. Sein
+	 *  Exit-Code ist Thread::KILLED.
 	 *  \param that Thread, der beendet werden soll.
+	 */
+	void kill(Thread *that);
+
+	/*! \brief Wartet, bis \p that sich beendet hat oder beendet wurde.
 	 *
-	 *  \todo Methode implementieren
+	 *  Danach läuft \p that auf keiner CPU mehr und darf gelöscht werden.
+	 *  Darf nur aus einem Thread heraus aufgerufen werden, und nicht für
+	 *  einen abgekoppelten Thread (siehe detach()).
+	 *  \return Exit-Code von \p that
+	 */
+	int join(Thread *that);
+
+	/*! \brief Koppelt \p that ab: der Scheduler löscht ihn selbst, sobald er
+	 *  sich beendet hat, bzw. sofort, falls das schon geschehen ist.
 	 *
+	 *  \p that muss mit new angelegt worden sein.
 	 */
-	void kill(Thread *that);
+	void detach(Thread *that);
 
 	/*! \brief Auslösen eines Threadwechsels
 	 *
@@ -113,6 +147,14 @@ public:
     void set_idle_thread(int cpuid, Thread *thread);
 
     void wakeup(Thread *customer);
+
+    /*! \brief Weckt \p customer wie wakeup(), lässt ihn aber sofort auf dieser
+     *  CPU weiterlaufen; der aktive Thread kommt dafür auf die Bereitliste.
+     *
+     *  Für die direkte Übergabe einer Nachricht an einen wartenden Empfänger
+     *  (siehe Channel). Darf nur aus einem Thread heraus aufgerufen werden.
+     */
+    void handoff(Thread *customer);
 };
 
 extern Scheduler scheduler;
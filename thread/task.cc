@@ -0,0 +1,112 @@
+// vim: set et ts=4 sw=4:
+
+#include "thread/task.h"
+#include "thread/scheduler.h"
+#include "machine/apicsystem.h"
+#include "machine/clock.h"
+#include "guard/secure.h"
+#include "syscall/guarded_scheduler.h"
+
+static Executor *executors[CPU_MAX];
+
+void Task::sleep_for(unsigned int ms) {
+    wake_at = Clock::now_ns() + (uint64_t) ms * 1000000;
+}
+
+void Task_Signal::post() {
+    if (Task *task = waiting.dequeue()) {
+        task->executor->make_ready(task);
+    } else {
+        count++;
+    }
+}
+
+void Executor::start() {
+    for (unsigned int i = 0; i < system.getNumberOfCPUs(); i++) {
+        executors[i] = new Executor;
+        Guarded_Scheduler::ready(executors[i]);
+    }
+}
+
+void Executor::spawn(Task *task) {
+    Secure s;
+    Executor *e = executors[system.getCPUID()];
+    task->executor = e;
+    e->make_ready(task);
+}
+
+void Executor::make_ready(Task *task) {
+    ready.enqueue(task);
+    if (Thread *t = idle.first()) {
+        scheduler.wakeup(t);
+    }
+}
+
+void Executor::add_sleeper(Task *task) {
+    Task *prev = nullptr;
+    for (Task *t : sleeping) {
+        if (t->wake_at > task->wake_at) {
+            break;
+        }
+        prev = t;
+    }
+    if (prev == nullptr) {
+        sleeping.insert_first(task);
+        timer.start_at(task->wake_at);
+    } else {
+        sleeping.insert_after(prev, task);
+    }
+}
+
+void Executor::wake_sleepers(void *executor) {
+    Executor *e = static_cast<Executor *>(executor);
+    uint64_t now = Clock::now_ns();
+
+    Task *t;
+    while ((t = e->sleeping.first()) && t->wake_at <= now) {
+        e->sleeping.dequeue();
+        e->make_ready(t);
+    }
+    if (t) {
+        e->timer.start_at(t->wake_at);
+    }
+}
+
+void Executor::action() {
+    for (;;) {
+        Task *task;
+        {
+            Secure s;
+            while (!(task = ready.dequeue())) {
+                scheduler.block(&idle);
+            }
+        }
+
+        Task::Status status = task->run();
+
+        Secure s;
+        switch (status) {
+        case Task::YIELD:
+            ready.enqueue(task);
+            break;
+        case Task::SLEEP:
+            if (task->wake_at <= Clock::now_ns()) {
+                ready.enqueue(task);
+            } else {
+                add_sleeper(task);
+            }
+            break;
+        case Task::WAIT:
+            if (task->signal->count > 0) {
+                task->signal->count--;
+                ready.enqueue(task);
+            } else {
+                task->signal->waiting.enqueue(task);
+            }
+            break;
+        case Task::DONE:
+            __atomic_store_n(&task->finished, true, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the stackless tasks: Task, Task_Signal and Executor.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "object/queue.h"
+#include "object/queuelink.h"
+#include "meeting/timer.h"
+#include "meeting/waitingroom.h"
+#include "thread/thread.h"
+
+class Executor;
+class Task_Signal;
+
+/*! \def TASK_BEGIN()
+ *  \brief Must come first in Task::run(): continues where the task stopped.
+ */
+#define TASK_BEGIN() switch (resume) { case 0:
+
+/*! \def TASK_END()
+ *  \brief Must come last in Task::run(): the task is done.
+ */
+#define TASK_END() } resume = 0; return Task::DONE
+
+// returns STATUS to the executor and continues right here next time: the
+// line number is the case label that TASK_BEGIN() jumps to.
+#define TASK_SUSPEND_(STATUS) \
+    do { resume = __LINE__; return Task::STATUS; case __LINE__:; } while (0)
+
+/*! \def TASK_YIELD()
+ *  \brief Lets the other tasks of the executor run first.
+ */
+#define TASK_YIELD() TASK_SUSPEND_(YIELD)
+
+/*! \def TASK_WAIT_UNTIL(cond)
+ *  \brief Yields until \p cond is true, which is polled every round.
+ */
+#define TASK_WAIT_UNTIL(cond) do { while (!(cond)) { TASK_YIELD(); } } while (0)
+
+/*! \def TASK_SLEEP(ms)
+ *  \brief Continues after \p ms milliseconds.
+ */
+#define TASK_SLEEP(ms) do { sleep_for(ms); TASK_SUSPEND_(SLEEP); } while (0)
+
+/*! \def TASK_WAIT(signal)
+ *  \brief Continues once Task_Signal \p signal has been posted.
+ */
+#define TASK_WAIT(signal) do { wait_for(&(signal)); TASK_SUSPEND_(WAIT); } while (0)
+
+/*! \brief An activity without a stack of its own, run by an Executor thread.
+ *  \ingroup thread
+ *
+ *  A task is a state machine: run() returns whenever the task has to wait,
+ *  and the next call continues after the place it returned from. The
+ *  TASK_* macros hide that, so run() reads like the body of a thread:
+ *
+ *      Task::Status run() override {
+ *          TASK_BEGIN();
+ *          for (i = 0; i < 10; i++) {
+ *              TASK_SLEEP(100);
+ *              kout << i << endl;
+ *          }
+ *          TASK_END();
+ *      }
+ *
+ *  As there is no stack, local variables lose their values at every TASK_*
+ *  macro; state that is needed afterwards (like \c i above) has to be a
+ *  member. The macros expand to the case labels of one big switch, so only
+ *  one of them may be used per line, and none inside a switch of the task
+ *  itself. run() may call non-blocking functions only; blocking would stop
+ *  all tasks of the executor.
+ *
+ *  A task costs the size of its object, a few dozen bytes, instead of the
+ *  stack of a thread.
+ */
+class Task {
+    // Disallow copies and assignments.
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+
+    friend class Executor;
+    friend class Task_Signal;
+
+    Executor *executor;
+    union {
+        uint64_t wake_at;       // SLEEP: deadline, see Clock::now_ns()
+        Task_Signal *signal;    // WAIT
+    };
+    bool finished;
+
+public:
+    enum Status { YIELD, SLEEP, WAIT, DONE };
+
+    QueueLink<Task> queue_link;
+
+    Task() : executor(nullptr), wake_at(0), finished(false), resume(0) {}
+
+    virtual ~Task() {}
+
+    /*! \brief Runs the task until it waits or is done; see above.
+     */
+    virtual Status run() = 0;
+
+    //! \brief true once run() has returned DONE.
+    bool done() const {
+        return __atomic_load_n(&finished, __ATOMIC_ACQUIRE);
+    }
+
+protected:
+    unsigned int resume; // line where run() continues, set by the TASK_* macros
+
+    void sleep_for(unsigned int ms);
+
+    void wait_for(Task_Signal *s) {
+        signal = s;
+    }
+};
+
+/*! \brief Counting signal for tasks, like a Semaphore for threads.
+ *  \ingroup thread
+ *
+ *  post() must be called at epilogue level, e.g. by a Timer callback.
+ */
+class Task_Signal {
+    // Disallow copies and assignments.
+    Task_Signal(const Task_Signal&)            = delete;
+    Task_Signal& operator=(const Task_Signal&) = delete;
+
+    friend class Executor;
+
+    Queue<Task> waiting;
+    unsigned int count;
+
+public:
+    Task_Signal(unsigned int count = 0) : count(count) {}
+
+    //! \brief Continues the first waiting task, or is remembered for the
+    //! next one.
+    void post();
+};
+
+/*! \brief Thread that runs tasks, one per CPU.
+ *  \ingroup thread
+ *
+ *  The tasks of an executor take turns: each gets to run until its next
+ *  TASK_* macro. Sleeping tasks are sorted by deadline and a single Timer
+ *  wakes the first one, so waiting tasks cost no time at all.
+ */
+class Executor final : public Thread {
+    // Disallow copies and assignments.
+    Executor(const Executor&)            = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    friend class Task_Signal;
+
+    Queue<Task> ready;
+    Queue<Task> sleeping;
+    Waitingroom idle;
+    Timer timer;
+
+    static void wake_sleepers(void *executor);
+
+    // both at epilogue level
+    void make_ready(Task *task);
+    void add_sleeper(Task *task);
+
+public:
+    Executor() : timer(wake_sleepers, this) {}
+
+    void action() override;
+
+    /*! \brief Creates one executor per CPU; must be called once at boot.
+     */
+    static void start();
+
+    /*! \brief Lets the executor of the current CPU run \p task, which must
+     *  stay alive until it is done().
+     */
+    static void spawn(Task *task);
+};
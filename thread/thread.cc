@@ -5,23 +5,32 @@
 #include "utils/heap.h"
 #include "debug/output.h"
 #include "user/mutex/mutex.h"
+#include "meeting/rwlock.h"
+#include "debug/assert.h"
 
 
-Thread::Thread(void *tos) : waitingroom(0), stack(nullptr), killed(false) {
+Thread::Thread(void *tos) : waitingroom(0), stack(nullptr), killed(false), run_state(NEW),
+                            cpu(-1), exit_status(0), detached(false), timeout(nullptr) {
+    for (RWLock *&l : rwlocks) {
+        l = nullptr;
+    }
     toc_settle(&regs, tos, Dispatcher::kickoff, this);
 }
 
-Thread::Thread() : waitingroom(0), killed(false) {
+Thread::Thread() : waitingroom(0), killed(false), run_state(NEW), cpu(-1), exit_status(0),
+                   detached(false), timeout(nullptr) {
     stack = new char[STACK_SIZE];
     void *tos = &stack[STACK_SIZE - 4];
+    for (RWLock *&l : rwlocks) {
+        l = nullptr;
+    }
     toc_settle(&regs, tos, Dispatcher::kickoff, this);
 }
 
+// Scheduler::finish() leaves the stack alone, as the thread still runs on
+// it until the next thread has taken over the CPU.
 Thread::~Thread() {
-    if (stack) {
-        delete[] stack;
-    }
-    mutex_release_all();
+    delete[] stack;
 }
 
 void Thread::go() {
@@ -47,6 +56,18 @@ bool Thread::dying() {
     return killed;
 }
 
+Thread::State Thread::state() {
+    return run_state;
+}
+
+bool Thread::dead() {
+    return run_state == ZOMBIE;
+}
+
+int Thread::exit_code() {
+    return exit_status;
+}
+
 Waitingroom *Thread::waiting_in() {
     return waitingroom;
 }
@@ -55,20 +76,57 @@ void Thread::waiting_in(Waitingroom *w) {
     waitingroom = w;
 }
 
+Timeout *Thread::wait_timeout() {
+    return timeout;
+}
+
+void Thread::wait_timeout(Timeout *t) {
+    timeout = t;
+}
+
 void Thread::mutex_hold(Mutex *m) {
     mutex_list.enqueue(m);
 }
 
 bool Thread::mutex_release(Mutex *m) {
-    return mutex_list.remove(m);
+    return mutex_list.remove(m) != nullptr;
 }
 
 // must be called from epilogue-level!
 // (or: if e.g. kill and exit at same time, v() would called twice)
 bool Thread::mutex_release_all() {
     bool ret = true;
-    for (Mutex *m : mutex_list) {
+    // unlock() takes the mutex off the list
+    while (Mutex *m = mutex_list.first()) {
         ret &= m->unlock();
     }
     return ret;
 }
+
+void Thread::rwlock_hold(RWLock *l) {
+    for (RWLock *&slot : rwlocks) {
+        if (slot == nullptr) {
+            slot = l;
+            return;
+        }
+    }
+    assert(!"Thread: too many RWLocks held");
+}
+
+void Thread::rwlock_release(RWLock *l) {
+    for (RWLock *&slot : rwlocks) {
+        if (slot == l) {
+            slot = nullptr;
+            return;
+        }
+    }
+}
+
+void Thread::rwlock_release_all() {
+    for (RWLock *&slot : rwlocks) {
+        if (RWLock *l = slot) {
+            slot = nullptr;
+            l->release(this);
+        }
+    }
+}
@@ -16,18 +16,43 @@
 #pragma once
 
 #include "machine/toc.h"
-#include "object/queuelink.h"
+#include "object/list.h"
 #include "meeting/waitingroom.h"
 
 class Mutex;
+class RWLock;
+class Timeout;
 
 /*! \brief Der Thread ist das Objekt der Ablaufplanung.
  *  \ingroup thread
+ *
+ *  A thread that has exited or been killed stays a zombie until it is
+ *  deleted, so that its exit code can still be read. Either its creator
+ *  waits for it with Scheduler::join() and deletes it afterwards, or it is
+ *  detached (Scheduler::detach()) and the scheduler deletes it once it is
+ *  done; a detached thread must have been created with new.
  */
 class Thread {
+    friend class Scheduler;
+    friend class Dispatcher;
+
 public:
     static const unsigned long STACK_SIZE = 8 * 1024;
 
+    // exit code of a thread that has been killed
+    static const int KILLED = -1;
+
+    // RWLocks a thread can hold at once
+    static const unsigned int RWLOCKS_MAX = 4;
+
+    enum State {
+        NEW,        // not made ready yet
+        READY,      // in the ready list
+        RUNNING,    // active on a CPU
+        BLOCKED,    // in a waitingroom
+        ZOMBIE,     // exited or killed, waits to be joined or reaped
+    };
+
 	/*! \brief Konstruktor.
 	 *
 	 *
@@ -38,10 +63,12 @@ public:
 	Thread(void *tos);
     Thread(); // allocates memory for stack itself
 
-    ~Thread();
+    // frees the stack; the thread must be NEW or a ZOMBIE by now.
+    virtual ~Thread();
 
-	/*! \brief Verkettungszeiger für Scheduler und Waitingroom */
-	QueueLink<Thread> queue_link;
+	/*! \brief Verkettungszeiger für die Ready-Liste, Waitingroom und die
+	 *  Zombies des Schedulers */
+	ListLink<Thread> list_link;
 
     Waitingroom *waitingroom;
 
@@ -49,9 +76,18 @@ private:
     char *stack;
     struct toc regs;
     volatile bool killed;
-    
+    volatile State run_state;
+    int cpu;            // CPU the thread runs on while it is RUNNING
+    int exit_status;
+    bool detached;
+    Waitingroom joiners;
+    Timeout *timeout; // bounds the current wait, see Waitingroom::remove()
+
     // everything added to mutex_list will be released upon exiting/killing
-    Queue<Mutex> mutex_list;
+    List<Mutex> mutex_list;
+
+    // likewise for RWLocks, which can have several holders
+    RWLock *rwlocks[RWLOCKS_MAX];
 
 public:
 	/*! \brief Aktiviert den ersten Thread auf einem Prozessor.
@@ -89,11 +125,30 @@ public:
 
     bool dying();
 
+    State state();
+
+    // true once the thread is a ZOMBIE. Only reliable inside the guard: the
+    // thread may still be on its way out otherwise.
+    bool dead();
+
+    // valid once the thread is dead(): the value passed to
+    // Scheduler::exit(), or KILLED.
+    int exit_code();
+
     Waitingroom *waiting_in();
 
     void waiting_in(Waitingroom *w);
 
+    Timeout *wait_timeout();
+
+    void wait_timeout(Timeout *t);
+
     void mutex_hold(Mutex *m);
     bool mutex_release(Mutex *m);
     bool mutex_release_all();
+
+    void rwlock_hold(RWLock *l);
+    void rwlock_release(RWLock *l);
+    // must be called from epilogue-level, like mutex_release_all()
+    void rwlock_release_all();
 };
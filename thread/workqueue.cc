@@ -0,0 +1,88 @@
+// vim: set et ts=4 sw=4:
+
+#include "thread/workqueue.h"
+#include "thread/scheduler.h"
+#include "machine/cpu.h"
+#include "guard/secure.h"
+#include "syscall/guarded_scheduler.h"
+
+Workqueue workqueue(false);
+Workqueue ordered_workqueue(true, 16);
+
+class Worker final : public Thread {
+    // Disallow copies and assignments.
+    Worker(const Worker&)            = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    Workqueue &wq;
+    Workqueue::Lane &lane;
+
+public:
+    Worker(Workqueue &wq, Workqueue::Lane &lane) : Thread(), wq(wq), lane(lane) {}
+
+    void action() override {
+        wq.run(lane);
+    }
+};
+
+void Workqueue::start() {
+    unsigned int workers = ordered ? 1 : system.getNumberOfCPUs();
+    for (unsigned int i = 0; i < workers; i++) {
+        Guarded_Scheduler::ready(new Worker(*this, lanes[i]));
+    }
+}
+
+bool Workqueue::queue(Work *work) {
+    if (__atomic_exchange_n(&work->queued, true, __ATOMIC_ACQ_REL)) {
+        return false;
+    }
+
+    Lane &lane = current_lane();
+    bool ints = CPU::disable_int();
+    lane.lock.lock();
+    lane.items.enqueue(work);
+    lane.lock.unlock();
+    CPU::restore_int(ints);
+    return true;
+}
+
+void Workqueue::kick() {
+    if (Thread *worker = current_lane().idle.first()) {
+        scheduler.wakeup(worker);
+    }
+}
+
+Work *Workqueue::take(Lane &lane) {
+    bool ints = CPU::disable_int();
+    lane.lock.lock();
+    Work *work = lane.items.dequeue();
+    lane.lock.unlock();
+    CPU::restore_int(ints);
+
+    // from now on, queueing the item again means running it again, so the
+    // item has to look at its data only after this.
+    if (work) {
+        __atomic_store_n(&work->queued, false, __ATOMIC_RELEASE);
+    }
+    return work;
+}
+
+void Workqueue::run(Lane &lane) {
+    for (;;) {
+        unsigned int n = 0;
+        while (Work *work = take(lane)) {
+            work->func(work->arg);
+            if (batch != 0 && ++n == batch) {
+                n = 0;
+                Guarded_Scheduler::resume();
+            }
+        }
+
+        // an item queued after the check has its kick() run after block(),
+        // as kick() needs the guard.
+        Secure s;
+        if (lane.items.first() == nullptr) {
+            scheduler.block(&lane.idle);
+        }
+    }
+}
@@ -0,0 +1,132 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the classes Work and Workqueue.
+ */
+
+#pragma once
+
+#include "types.h"
+#include "object/queue.h"
+#include "object/queuelink.h"
+#include "meeting/waitingroom.h"
+#include "machine/apicsystem.h"
+#include "machine/spinlock.h"
+
+class Workqueue;
+
+/*! \brief A function call that a Workqueue runs in one of its worker threads.
+ *  \ingroup thread
+ *
+ *  An item is usually static or part of the object whose work it does. While
+ *  it is queued, queueing it again does nothing, so several requests that
+ *  come in before the worker gets to it are handled by one call (e.g. one
+ *  call echoes all characters received until then).
+ */
+class Work {
+    // Disallow copies and assignments.
+    Work(const Work&)            = delete;
+    Work& operator=(const Work&) = delete;
+
+    friend class Workqueue;
+
+    void (*func)(void *);
+    void *arg;
+    bool queued;
+
+public:
+    QueueLink<Work> queue_link;
+
+    Work(void (*func)(void *), void *arg = nullptr) : func(func), arg(arg), queued(false) {}
+
+    //! \brief true while the item waits for its worker.
+    bool pending() const {
+        return __atomic_load_n(&queued, __ATOMIC_RELAXED);
+    }
+};
+
+/*! \brief Runs Work items in worker threads, to keep work that may take
+ *  long or has to block out of the epilogues.
+ *  \ingroup thread
+ *
+ *  An interrupt handler only queues an item and wakes the worker, which then
+ *  runs the item like any other thread: with interrupts and epilogues
+ *  enabled, and allowed to block (e.g. on kout_mutex).
+ *
+ *  An unordered queue has one list and one worker per CPU; queue() picks
+ *  the list of the current CPU, so CPUs do not contend for it. Items from
+ *  different CPUs may run concurrently and in any order; an item that is
+ *  queued again while it runs may even run twice at the same time. An
+ *  ordered queue has a single list and worker and runs its items one after
+ *  the other, in the order they were queued.
+ *
+ *  The worker runs all queued items before it sleeps again. With a batch
+ *  size, it lets other threads run after that many items.
+ */
+class Workqueue {
+    // Disallow copies and assignments.
+    Workqueue(const Workqueue&)            = delete;
+    Workqueue& operator=(const Workqueue&) = delete;
+
+    friend class Worker;
+
+    struct Lane {
+        Spinlock lock;
+        Queue<Work, &Work::queue_link> items;
+        Waitingroom idle;
+    };
+
+    Lane lanes[CPU_MAX];
+    const bool ordered;
+    const unsigned int batch;
+
+    Lane &current_lane() {
+        return lanes[ordered ? 0 : system.getCPUID()];
+    }
+
+    Work *take(Lane &lane);
+
+    // body of the worker threads
+    void run(Lane &lane);
+
+public:
+    /*! \param ordered Use a single worker for all CPUs, see above.
+     *  \param batch Items to run before letting other threads run; 0 for no
+     *  limit.
+     */
+    Workqueue(bool ordered, unsigned int batch = 0) : ordered(ordered), batch(batch) {}
+
+    /*! \brief Creates the worker threads; must be called once at boot.
+     */
+    void start();
+
+    /*! \brief Queues \p work, without waking the worker.
+     *
+     *  Can be called anywhere, even in a prologue; kick() has to follow at
+     *  epilogue level.
+     *  \return false if the item was already queued
+     */
+    bool queue(Work *work);
+
+    /*! \brief Wakes the worker that queue() on this CPU feeds, if it sleeps.
+     *
+     *  Must be called at epilogue level.
+     */
+    void kick();
+
+    /*! \brief queue() and kick() at once; must be called at epilogue level.
+     */
+    bool submit(Work *work) {
+        bool queued = queue(work);
+        kick();
+        return queued;
+    }
+};
+
+/*! \brief Unordered queue for short jobs of interrupt handlers.
+ */
+extern Workqueue workqueue;
+
+/*! \brief Ordered queue, e.g. for output that must keep its order.
+ */
+extern Workqueue ordered_workqueue;
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# vim: set et ts=4 sw=4:
+"""Convert a kernel trace dump (`trace dump` in the shell) into the Chrome
+trace event format, which can be loaded into chrome://tracing or Perfetto.
+
+Usage: trace2json.py [--mhz MHZ] [dump.txt] > trace.json
+
+The dump is read from the serial console log; lines not between the
+`# trace begin` and `# trace end` markers are ignored.  Timestamps are TSC
+ticks; they are converted into microseconds with the TSC frequency that the
+kernel measured at boot (`tsc_khz=` in the begin marker), unless --mhz is
+given.
+"""
+
+import argparse
+import json
+import sys
+
+
+def parse(lines):
+    events = []
+    mhz = None
+    inside = False
+    for line in lines:
+        line = line.strip()
+        if line.startswith('# trace begin'):
+            inside = True
+            events = []
+            for field in line.split()[3:]:
+                key, _, value = field.partition('=')
+                if key == 'tsc_khz' and int(value) > 0:
+                    mhz = int(value) / 1000.0
+            continue
+        if line.startswith('# trace end'):
+            inside = False
+            continue
+        if not inside or not line or line.startswith('#'):
+            continue
+        fields = line.split()
+        if len(fields) != 5:
+            continue
+        cpu, tsc_hi, tsc_lo, kind, arg = fields
+        tsc = (int(tsc_hi, 16) << 32) | int(tsc_lo, 16)
+        events.append((int(cpu), tsc, kind, int(arg, 16)))
+    return events, mhz
+
+
+def convert(events, mhz):
+    if not events:
+        return []
+
+    base = min(e[1] for e in events)
+    out = []
+    for cpu in sorted(set(e[0] for e in events)):
+        out.append({'ph': 'M', 'name': 'thread_name', 'pid': 0, 'tid': cpu,
+                    'args': {'name': 'CPU%d' % cpu}})
+
+    def ts(tsc):
+        return (tsc - base) / mhz
+
+    running = {}
+    for cpu, tsc, kind, arg in sorted(events, key=lambda e: (e[0], e[1])):
+        common = {'pid': 0, 'tid': cpu, 'ts': ts(tsc)}
+        if kind == 'switch':
+            # one slice per thread run, ended by the next switch on this CPU
+            if cpu in running:
+                out.append(dict(common, ph='E', name=running[cpu]))
+            running[cpu] = 'thread %#x' % arg
+            out.append(dict(common, ph='B', name=running[cpu]))
+        elif kind == 'irq_entry':
+            out.append(dict(common, ph='B', name='irq %d' % arg, cat='irq'))
+        elif kind == 'irq_exit':
+            out.append(dict(common, ph='E', name='irq %d' % arg, cat='irq'))
+        else:
+            out.append(dict(common, ph='i', s='t', name=kind,
+                            args={'arg': '%#x' % arg}))
+
+    last = max(e[1] for e in events)
+    for cpu, name in running.items():
+        out.append({'ph': 'E', 'pid': 0, 'tid': cpu, 'ts': ts(last),
+                    'name': name})
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--mhz', type=float,
+                        help='TSC frequency in MHz (default: from the dump, '
+                             'else 1000)')
+    parser.add_argument('dump', nargs='?', type=argparse.FileType('r'),
+                        default=sys.stdin)
+    args = parser.parse_args()
+
+    events, mhz = parse(args.dump)
+    mhz = args.mhz or mhz or 1000.0
+    json.dump({'traceEvents': convert(events, mhz),
+               'displayTimeUnit': 'ns'}, sys.stdout)
+    sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+    main()
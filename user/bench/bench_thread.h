@@ -0,0 +1,23 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+#include "syscall/guarded_scheduler.h"
+#include "thread/thread.h"
+
+// Thread running a plain function for the benchmarks; wait for it with
+// Guarded_Scheduler::join() before deleting it.
+class Bench_Thread final : public Thread {
+    Bench_Thread(const Bench_Thread&)            = delete;
+    Bench_Thread& operator=(const Bench_Thread&) = delete;
+
+    void (*body)();
+
+public:
+    explicit Bench_Thread(void (*body)()) : Thread(), body(body) {}
+
+    void action() override {
+        body();
+        Guarded_Scheduler::exit();
+    }
+};
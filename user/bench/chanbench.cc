@@ -0,0 +1,63 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command chanbench, which measures request/reply
+ *  round trips over two Guarded_Channels and checks recv() with a timeout.
+ *
+ *  The shell thread sends each number to an echo thread, which sends it back
+ *  incremented by one. As the other side is usually already waiting, most
+ *  messages are handed over directly.
+ */
+
+#include "machine/clock.h"
+#include "machine/cpu.h"
+#include "object/format.h"
+#include "syscall/guarded_channel.h"
+#include "user/bench/bench_thread.h"
+#include "user/shell/shell.h"
+#include "utils/math.h"
+
+static Guarded_Channel<unsigned, 4> requests;
+static Guarded_Channel<unsigned, 4> replies;
+
+static void echo() {
+    unsigned val;
+    for (;;) {
+        requests.recv(val);
+        if (val == 0) {
+            break;
+        }
+        replies.send(val + 1);
+    }
+}
+
+SHELL_COMMAND(chanbench, "measures round trips over channels") {
+    const unsigned rounds = 10000;
+    Bench_Thread *server = new Bench_Thread(echo);
+    Guarded_Scheduler::ready(server);
+
+    bool ok = true;
+    unsigned val;
+    uint64_t start = CPU::rdtsc();
+    for (unsigned i = 1; i <= rounds; i++) {
+        requests.send(i);
+        replies.recv(val);
+        ok &= val == i + 1;
+    }
+    uint64_t cycles = CPU::rdtsc() - start;
+
+    requests.send(0);
+    Guarded_Scheduler::join(server);
+    delete server;
+
+    format(ctx.out, FMT("{} round trips, {} cycles each{}\n"), rounds,
+           (unsigned) Math::div64(cycles, rounds), ok ? "" : " (wrong replies!)");
+
+    // nobody answers now, so this has to time out.
+    uint64_t start_ns = Clock::now_ns();
+    bool got = replies.recv(val, 10);
+    uint64_t ns = Clock::now_ns() - start_ns;
+    format(ctx.out, FMT("recv with 10 ms timeout: {} after {} us\n"),
+           got ? "got a message (wrong!)" : "timed out",
+           (unsigned) Math::div64(ns, 1000)) << flush;
+}
@@ -0,0 +1,65 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command listbench, which compares the singly
+ *  linked Queue with the doubly linked List.
+ *
+ *  Both get the same nodes, first in FIFO order (enqueue all, then dequeue
+ *  all), and then removed from the back to the front, which is the worst
+ *  case for Queue::remove(): it has to walk the whole list every time.
+ */
+
+#include "machine/cpu.h"
+#include "object/format.h"
+#include "object/list.h"
+#include "object/queue.h"
+#include "user/shell/shell.h"
+#include "utils/math.h"
+
+// the nodes come from the kernel heap, and Queue needs n^2 / 2 steps to
+// remove n items from the back.
+static const long MAX_ITEMS = 10000;
+
+struct Node {
+    QueueLink<Node> queue_link;
+    ListLink<Node> list_link;
+};
+
+template <typename Container>
+static void run(O_Stream &out, const char *name, Node *nodes, unsigned n) {
+    Container list;
+
+    uint64_t start = CPU::rdtsc();
+    for (unsigned i = 0; i < n; i++) {
+        list.enqueue(&nodes[i]);
+    }
+    while (list.dequeue()) {}
+    uint64_t fifo = CPU::rdtsc() - start;
+
+    for (unsigned i = 0; i < n; i++) {
+        list.enqueue(&nodes[i]);
+    }
+    start = CPU::rdtsc();
+    for (unsigned i = n; i-- > 0;) {
+        list.remove(&nodes[i]);
+    }
+    uint64_t remove = CPU::rdtsc() - start;
+
+    format(out, FMT("{:<5}  fifo: {} cycles/item  remove: {} cycles/item\n"), name,
+           (unsigned) Math::div64(fifo, n), (unsigned) Math::div64(remove, n)) << flush;
+}
+
+SHELL_COMMAND(listbench, "[<n>]: compares Queue and List with n (1000) items") {
+    StringView n_s = ctx.args.tok(" ");
+    bool error = false;
+    long n = n_s.empty() ? 1000 : strtol(n_s, &error);
+    if (error || n <= 0 || n > MAX_ITEMS) {
+        ctx.error("usage: listbench [<n>], at most 10000");
+        return;
+    }
+
+    Node *nodes = new Node[n];
+    run<Queue<Node>>(ctx.out, "Queue", nodes, n);
+    run<List<Node>>(ctx.out, "List", nodes, n);
+    delete[] nodes;
+}
@@ -0,0 +1,128 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command ringbench, which measures the
+ *  throughput of BBuffer and MPMC_BBuffer between threads on different CPUs.
+ *
+ *  The producers push the numbers 1 to n, the consumers add up what they
+ *  pop, and the sum tells whether any item was lost or duplicated. Once all
+ *  producers are done, the last one pushes a 0 for every consumer to stop.
+ *  A thread that finds the buffer full or empty yields, so the benchmark
+ *  also completes if its threads share a CPU.
+ */
+
+#include "object/bbuffer.h"
+#include "object/format.h"
+#include "machine/cpu.h"
+#include "guard/secure.h"
+#include "syscall/guarded_scheduler.h"
+#include "user/bench/bench_thread.h"
+#include "user/shell/shell.h"
+#include "utils/math.h"
+
+static const unsigned MAX_THREADS = 4;
+static const unsigned RING_SIZE   = 1024;
+
+static struct {
+    unsigned items; // per producer
+    unsigned producers;
+    unsigned consumers;
+    unsigned producers_done;
+    unsigned long long sum;
+} bench;
+
+template <typename Buffer>
+struct Ring_Bench {
+    static Buffer buf;
+
+    static void push(unsigned val) {
+        while (!buf.produce(val)) {
+            Guarded_Scheduler::resume();
+        }
+    }
+
+    static void producer() {
+        for (unsigned i = 1; i <= bench.items; i++) {
+            push(i);
+        }
+        if (__atomic_add_fetch(&bench.producers_done, 1, __ATOMIC_ACQ_REL) == bench.producers) {
+            for (unsigned i = 0; i < bench.consumers; i++) {
+                push(0);
+            }
+        }
+    }
+
+    static void consumer() {
+        unsigned long long sum = 0;
+        unsigned val;
+        for (;;) {
+            if (!buf.consume(val)) {
+                Guarded_Scheduler::resume();
+            } else if (val == 0) {
+                break;
+            } else {
+                sum += val;
+            }
+        }
+        Secure s; // there are no 64-bit atomics here
+        bench.sum += sum;
+    }
+
+    static void run(O_Stream &out, const char *name, unsigned producers, unsigned consumers,
+                    unsigned items) {
+        bench.items = items / producers;
+        bench.producers = producers;
+        bench.consumers = consumers;
+        bench.producers_done = 0;
+        bench.sum = 0;
+
+        Bench_Thread *threads[2 * MAX_THREADS];
+        unsigned n = 0;
+        for (unsigned i = 0; i < consumers; i++) {
+            threads[n++] = new Bench_Thread(consumer);
+        }
+        for (unsigned i = 0; i < producers; i++) {
+            threads[n++] = new Bench_Thread(producer);
+        }
+
+        uint64_t start = CPU::rdtsc();
+        for (unsigned i = 0; i < n; i++) {
+            Guarded_Scheduler::ready(threads[i]);
+        }
+        for (unsigned i = 0; i < n; i++) {
+            Guarded_Scheduler::join(threads[i]);
+        }
+        uint64_t cycles = CPU::rdtsc() - start;
+
+        for (unsigned i = 0; i < n; i++) {
+            delete threads[i];
+        }
+
+        unsigned total = bench.items * producers;
+        unsigned long long expected = (unsigned long long) bench.items * (bench.items + 1) / 2 * producers;
+        format(out, FMT("{:<4} {}P/{}C: {} items, {} cycles/item{}\n"), name, producers, consumers,
+               total, (unsigned) Math::div64(cycles, total),
+               bench.sum == expected ? "" : " (sum mismatch!)") << flush;
+    }
+};
+
+template <typename Buffer>
+Buffer Ring_Bench<Buffer>::buf;
+
+SHELL_COMMAND(ringbench, "[<producers> <consumers>]: measures the ring buffers across CPUs") {
+    StringView p_s = ctx.args.tok(" ");
+    StringView c_s = ctx.args.tok(" ");
+    bool p_error = false, c_error = false;
+    long producers = p_s.empty() ? 2 : strtol(p_s, &p_error);
+    long consumers = c_s.empty() ? 2 : strtol(c_s, &c_error);
+    if (p_error || c_error || producers < 1 || consumers < 1
+        || producers > (long) MAX_THREADS || consumers > (long) MAX_THREADS) {
+        ctx.error("usage: ringbench [<producers> <consumers>], at most 4 each");
+        return;
+    }
+
+    const unsigned items = 1 << 18;
+    Ring_Bench<BBuffer<unsigned, RING_SIZE>>::run(ctx.out, "spsc", 1, 1, items);
+    Ring_Bench<MPMC_BBuffer<unsigned, RING_SIZE>>::run(ctx.out, "mpmc", 1, 1, items);
+    Ring_Bench<MPMC_BBuffer<unsigned, RING_SIZE>>::run(ctx.out, "mpmc", producers, consumers, items);
+}
@@ -0,0 +1,115 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command sleepbench, which measures how much
+ *  longer than asked Guarded_Bell::sleep_us() and Guarded_Bell::sleep()
+ *  actually sleep, and how late the callbacks of a periodic Guarded_Timer
+ *  come.
+ *
+ *  sleep_us() must never return early. sleep() counts timer ticks, and the
+ *  first one may come right away, so it can return up to one tick early.
+ */
+
+#include "machine/clock.h"
+#include "object/format.h"
+#include "syscall/guarded_bell.h"
+#include "syscall/guarded_semaphore.h"
+#include "syscall/guarded_timer.h"
+#include "user/shell/shell.h"
+#include "utils/math.h"
+
+static const unsigned ROUNDS = 100;
+
+// Prints the average and worst delay in microseconds of "ROUNDS" calls of
+// "sleep(arg)", which should take "us" microseconds. Unless "may_be_early",
+// an early return is reported as an error; otherwise the worst early return
+// is printed as well.
+static void measure(O_Stream &out, const char *name, void (*sleep)(unsigned int),
+                    unsigned arg, unsigned us, bool may_be_early = false) {
+    uint64_t total = 0;
+    uint64_t worst = 0;
+    uint64_t worst_early = 0;
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        uint64_t start = Clock::now_ns();
+        sleep(arg);
+        uint64_t late = Clock::now_ns() - start - (uint64_t) us * 1000;
+        if ((int64_t) late < 0) {
+            if (!may_be_early) {
+                format(out, FMT("{}({}) returned too early!\n"), name, arg);
+            }
+            worst_early = Math::max(worst_early, -late);
+            late = 0;
+        }
+        total += late;
+        worst = Math::max(worst, late);
+    }
+    format(out, FMT("{}({:>5}): {:>5} us late on average, {:>5} at worst"), name, arg,
+           (unsigned) Math::div64(total, 1000 * ROUNDS),
+           (unsigned) Math::div64(worst, 1000));
+    if (may_be_early) {
+        format(out, FMT(", {:>5} early at worst"), (unsigned) Math::div64(worst_early, 1000));
+    }
+    out << endl;
+}
+
+static void sleep_ms(unsigned int ms) {
+    Guarded_Bell::sleep(ms);
+}
+
+static void sleep_us(unsigned int us) {
+    Guarded_Bell::sleep_us(us);
+}
+
+// The periodic timer: each callback should come "PERIOD" us after the
+// previous deadline, measured from "first".
+static const unsigned PERIOD = 500;
+
+static struct {
+    Timer *timer;
+    uint64_t first;
+    unsigned calls;
+    uint64_t total;
+    uint64_t worst;
+    Guarded_Semaphore done;
+} periodic;
+
+static void tick(void *) {
+    uint64_t due = periodic.first + (uint64_t) (periodic.calls + 1) * PERIOD * 1000;
+    uint64_t now = Clock::now_ns();
+    uint64_t late = now > due ? now - due : 0;
+    periodic.total += late;
+    periodic.worst = Math::max(periodic.worst, late);
+    if (++periodic.calls == ROUNDS) {
+        // the callback already runs at epilogue level
+        periodic.timer->Timer::cancel();
+        periodic.done.Semaphore::v();
+    }
+}
+
+static void measure_timer(O_Stream &out) {
+    Guarded_Timer timer(tick);
+    periodic.timer = &timer;
+    periodic.calls = 0;
+    periodic.total = periodic.worst = 0;
+    {
+        // the first callback must not come before "first" is set
+        Secure s;
+        periodic.first = Clock::now_ns();
+        timer.Timer::start_us(PERIOD, PERIOD);
+    }
+    periodic.done.p();
+
+    format(out, FMT("timer {} us: {:>5} us late on average, {:>5} at worst, {} overruns\n"),
+           PERIOD, (unsigned) Math::div64(periodic.total, 1000 * ROUNDS),
+           (unsigned) Math::div64(periodic.worst, 1000), timer.overruns()) << flush;
+}
+
+SHELL_COMMAND(sleepbench, "measures how precisely threads sleep and timers fire") {
+    const unsigned us[] = {5, 20, 100, 500, 2000};
+    for (unsigned i = 0; i < sizeof(us) / sizeof(us[0]); i++) {
+        measure(ctx.out, "sleep_us", sleep_us, us[i], us[i]);
+    }
+    measure(ctx.out, "sleep   ", sleep_ms, 1, 1000, true);
+    measure(ctx.out, "sleep   ", sleep_ms, 2, 2000, true);
+    measure_timer(ctx.out);
+}
@@ -0,0 +1,253 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command synctest, which runs Guarded_Barrier,
+ *  Guarded_RWLock and Guarded_ConditionVariable with several threads and
+ *  checks that they keep their promises, as well as the timed waits of
+ *  Guarded_Semaphore and Guarded_Mutex and killing threads that hold or
+ *  wait for an RWLock.
+ *
+ *  The threads yield inside their critical sections, so that they really
+ *  interleave even if they share a CPU.
+ */
+
+#include "object/format.h"
+#include "syscall/guarded_barrier.h"
+#include "syscall/guarded_bell.h"
+#include "syscall/guarded_condvar.h"
+#include "syscall/guarded_mutex.h"
+#include "syscall/guarded_rwlock.h"
+#include "syscall/guarded_semaphore.h"
+#include "user/bench/bench_thread.h"
+#include "user/shell/shell.h"
+
+static const unsigned THREADS = 4;
+static const unsigned ROUNDS  = 200;
+
+static unsigned errors;
+
+// Runs THREADS threads of "body" and waits for them.
+static void run(void (*body)()) {
+    Bench_Thread *threads[THREADS];
+    for (unsigned i = 0; i < THREADS; i++) {
+        threads[i] = new Bench_Thread(body);
+        Guarded_Scheduler::ready(threads[i]);
+    }
+    for (unsigned i = 0; i < THREADS; i++) {
+        Guarded_Scheduler::join(threads[i]);
+        delete threads[i];
+    }
+}
+
+static void report(O_Stream &out, const char *name, unsigned before) {
+    format(out, FMT("{:<9} {}\n"), name, errors == before ? "ok" : "FAILED") << flush;
+}
+
+/// Barrier: nobody may see the counter of the next round before all have
+/// added to it in this one.
+
+static Guarded_Barrier barrier(THREADS);
+static unsigned arrived;
+
+static void barrier_body() {
+    for (unsigned round = 1; round <= ROUNDS; round++) {
+        __atomic_fetch_add(&arrived, 1, __ATOMIC_RELAXED);
+        barrier.wait();
+        if (__atomic_load_n(&arrived, __ATOMIC_RELAXED) != round * THREADS) {
+            __atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+        }
+        barrier.wait();
+    }
+}
+
+/// RWLock: half of the threads write two values that must always be equal,
+/// the other half check them.
+
+static Guarded_RWLock rwlock;
+static unsigned value_a, value_b;
+static unsigned rw_index;
+
+static void rwlock_body() {
+    bool writer = __atomic_fetch_add(&rw_index, 1, __ATOMIC_RELAXED) % 2 == 0;
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        if (writer) {
+            rwlock.write_lock();
+            value_a++;
+            Guarded_Scheduler::resume();
+            value_b++;
+            rwlock.write_unlock();
+        } else {
+            rwlock.read_lock();
+            unsigned a = value_a;
+            Guarded_Scheduler::resume();
+            if (a != value_b) {
+                __atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+            }
+            rwlock.read_unlock();
+        }
+    }
+}
+
+/// ConditionVariable: producers and consumers pass items through a counter;
+/// every consumer has to get exactly as many as each producer makes.
+
+static Guarded_Mutex mutex;
+static Guarded_ConditionVariable cond;
+static unsigned items;
+static unsigned cv_index;
+
+static void condvar_body() {
+    bool producer = __atomic_fetch_add(&cv_index, 1, __ATOMIC_RELAXED) % 2 == 0;
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        mutex.lock();
+        if (producer) {
+            items++;
+            cond.notify_one();
+        } else {
+            while (items == 0) {
+                cond.wait(mutex);
+            }
+            items--;
+        }
+        mutex.unlock();
+    }
+}
+
+/// Timed waits: a wait that nobody ends has to time out, one that is ended
+/// in time must not, and the losing side must not disturb anything later.
+
+static Guarded_Semaphore signal;
+static Guarded_Mutex held;
+
+static void signal_body() {
+    Guarded_Bell::sleep(2);
+    signal.v();
+}
+
+static void holder_body() {
+    held.lock();
+    Guarded_Bell::sleep(20);
+    held.unlock();
+}
+
+static void check(bool ok) {
+    if (!ok) {
+        errors++;
+    }
+}
+
+static void run_timeouts() {
+    check(!signal.p_timeout(0));
+    check(!signal.p_timeout(5));
+
+    Bench_Thread *t = new Bench_Thread(signal_body);
+    Guarded_Scheduler::ready(t);
+    check(signal.p_timeout(100));
+    Guarded_Scheduler::join(t);
+    delete t;
+
+    // the timeout of the successful wait must be gone by now
+    Guarded_Bell::sleep(110);
+    signal.v();
+    check(signal.p_timeout(0));
+
+    t = new Bench_Thread(holder_body);
+    Guarded_Scheduler::ready(t);
+    Guarded_Bell::sleep(2);
+    check(!held.try_lock_for(5));
+    check(held.try_lock_for(100));
+    held.unlock();
+    Guarded_Scheduler::join(t);
+    delete t;
+}
+
+/// Kills: an RWLock held or waited for by a killed thread must not stay
+/// taken. A failure shows as synctest hanging in this part.
+
+static void write_holder_body() {
+    rwlock.write_lock();
+    Guarded_Bell::sleep(1000);
+    rwlock.write_unlock();
+}
+
+static void read_holder_body() {
+    rwlock.read_lock();
+    Guarded_Bell::sleep(20);
+    rwlock.read_unlock();
+}
+
+static void writer_body() {
+    rwlock.write_lock();
+    rwlock.write_unlock();
+}
+
+static void reader_body() {
+    rwlock.read_lock();
+    rwlock.read_unlock();
+}
+
+// Starts "body" and lets it run until it sleeps or blocks.
+static Bench_Thread *start(void (*body)()) {
+    Bench_Thread *t = new Bench_Thread(body);
+    Guarded_Scheduler::ready(t);
+    Guarded_Bell::sleep(2);
+    return t;
+}
+
+static void kill(Bench_Thread *t) {
+    Guarded_Scheduler::kill(t);
+    check(Guarded_Scheduler::join(t) == Thread::KILLED);
+    delete t;
+}
+
+static void finish(Bench_Thread *t) {
+    Guarded_Scheduler::join(t);
+    delete t;
+}
+
+static void run_kills() {
+    // a killed writer gives the lock back
+    kill(start(write_holder_body));
+    rwlock.write_lock();
+    rwlock.write_unlock();
+
+    // a reader queued behind a writer that is killed while waiting gets in
+    // once the lock is free
+    Bench_Thread *holder = start(read_holder_body);
+    Bench_Thread *writer = start(writer_body);
+    Bench_Thread *reader = start(reader_body);
+    kill(writer);
+    finish(holder);
+    finish(reader);
+}
+
+SHELL_COMMAND(synctest, "checks barriers, rwlocks, condition variables and timed waits") {
+    unsigned before = errors;
+    arrived = 0;
+    run(barrier_body);
+    report(ctx.out, "barrier", before);
+
+    before = errors;
+    rw_index = 0;
+    run(rwlock_body);
+    if (value_a != value_b) {
+        errors++;
+    }
+    report(ctx.out, "rwlock", before);
+
+    before = errors;
+    cv_index = 0;
+    run(condvar_body);
+    if (items != 0) {
+        errors++;
+    }
+    report(ctx.out, "condvar", before);
+
+    before = errors;
+    run_timeouts();
+    report(ctx.out, "timeouts", before);
+
+    before = errors;
+    run_kills();
+    report(ctx.out, "kills", before);
+}
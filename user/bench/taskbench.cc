@@ -0,0 +1,118 @@
+// vim: set et ts=4 sw=4:
+
+/*! \file
+ *  \brief Contains the shell command taskbench, which runs many stackless
+ *  tasks at once and measures how fast two tasks pass a Task_Signal back
+ *  and forth.
+ */
+
+#include "machine/clock.h"
+#include "object/format.h"
+#include "syscall/guarded_bell.h"
+#include "thread/task.h"
+#include "user/shell/shell.h"
+#include "utils/heap.h"
+#include "utils/math.h"
+
+static const unsigned ROUNDS = 5;
+
+// the sleepers come from the kernel heap.
+static const long MAX_TASKS = 10000;
+
+// The executor still touches a task after its last step, so a task may
+// only go away once it is done().
+static void wait_done(Task &task) {
+    while (!task.done()) {
+        Guarded_Bell::sleep(1);
+    }
+}
+
+// Sleeps ROUNDS times for a few milliseconds, yielding in between.
+class Sleeper : public Task {
+    unsigned id;
+    unsigned round;
+
+public:
+    Sleeper() : id(0), round(0) {}
+
+    void set_id(unsigned i) {
+        id = i;
+    }
+
+    Status run() override {
+        TASK_BEGIN();
+        for (round = 0; round < ROUNDS; round++) {
+            TASK_SLEEP(1 + id % 10);
+            TASK_YIELD();
+        }
+        TASK_END();
+    }
+};
+
+// Two of these pass the turn to each other "count" times.
+class Pingpong : public Task {
+    Task_Signal &mine;
+    Task_Signal &other;
+    unsigned count;
+
+public:
+    Pingpong(Task_Signal &mine, Task_Signal &other, unsigned count)
+        : mine(mine), other(other), count(count) {}
+
+    Status run() override {
+        TASK_BEGIN();
+        while (count-- > 0) {
+            TASK_WAIT(mine);
+            {
+                Secure s;
+                other.post();
+            }
+        }
+        TASK_END();
+    }
+};
+
+SHELL_COMMAND(taskbench, "[<n>]: runs n (1000, at most 10000) sleeping tasks and a ping-pong of two tasks") {
+    StringView n_s = ctx.args.tok(" ");
+    bool error = false;
+    long n = n_s.empty() ? 1000 : strtol(n_s, &error);
+    if (error || n <= 0 || n > MAX_TASKS) {
+        ctx.error("usage: taskbench [<n>], at most 10000");
+        return;
+    }
+
+    size_t heap_before = get_heap_stats().used;
+    Sleeper *sleepers = new Sleeper[n];
+    size_t heap = get_heap_stats().used - heap_before;
+
+    uint64_t start = Clock::now_ns();
+    for (long i = 0; i < n; i++) {
+        sleepers[i].set_id(i);
+        Executor::spawn(&sleepers[i]);
+    }
+    for (long i = 0; i < n; i++) {
+        wait_done(sleepers[i]);
+    }
+    uint64_t ns = Clock::now_ns() - start;
+    delete[] sleepers;
+
+    format(ctx.out, FMT("{} tasks of {} bytes ({} bytes of heap) slept {} times each in {} ms\n"),
+           n, sizeof(Sleeper), heap, ROUNDS, (unsigned) Math::div64(ns, 1000000)) << flush;
+
+    const unsigned turns = 10000;
+    Task_Signal ping, pong;
+    Pingpong a(ping, pong, turns), b(pong, ping, turns);
+    start = Clock::now_ns();
+    Executor::spawn(&a);
+    Executor::spawn(&b);
+    {
+        Secure s;
+        ping.post();
+    }
+    wait_done(a);
+    wait_done(b);
+    ns = Clock::now_ns() - start;
+
+    format(ctx.out, FMT("{} ping-pong turns, {} ns each\n"), 2 * turns,
+           (unsigned) Math::div64(ns, 2 * turns)) << flush;
+}
@@ -7,6 +7,15 @@ void Mutex::lock() {
     owner->mutex_hold(this);
 }
 
+bool Mutex::try_lock_for(unsigned int ms) {
+    if (!Semaphore::p_timeout(ms)) {
+        return false;
+    }
+    owner = scheduler.active();
+    owner->mutex_hold(this);
+    return true;
+}
+
 bool Mutex::unlock() {
     bool ret = owner->mutex_release(this);
     owner = nullptr;
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "meeting/semaphore.h"
-#include "object/queuelink.h"
+#include "object/list.h"
 #include "thread/thread.h"
 
 class Mutex : public Semaphore {
@@ -9,10 +9,13 @@ private:
     Thread *owner;
 
 public:
-    QueueLink<Mutex> queue_link;
+    ListLink<Mutex> list_link;
 
     Mutex() : Semaphore(1), owner(nullptr) {}
 
     void lock();
+    // waits at most "ms" milliseconds for the mutex; false if it did not
+    // get it in time.
+    bool try_lock_for(unsigned int ms);
     bool unlock();
 };
@@ -0,0 +1,44 @@
+// vim: set et ts=4 sw=4:
+
+#include "user/shell/job.h"
+#include "syscall/guarded_scheduler.h"
+
+void Job_Stream::flush() {
+    size_t n = pos;
+    if (n > CAPACITY - len) {
+        n = CAPACITY - len;
+        truncated = true;
+    }
+    for (size_t i = 0; i < n; i++) {
+        text[len + i] = buffer[i];
+    }
+    len += n;
+    pos = 0;
+}
+
+void Job::action() {
+    Shell_Context ctx = { shell, out, StringView(), StringView(line), true, nullptr, nullptr };
+    ctx.name = ctx.args.tok(" ");
+
+    handler(ctx);
+    out.flush();
+
+    Guarded_Scheduler::exit();
+}
+
+void Pipe_Stage::action() {
+    Shell_Context ctx = { shell, out, StringView(), line, true, in, &out };
+    ctx.name = ctx.args.tok(" ");
+
+    handler(ctx);
+    out.flush();
+
+    // let the next stage see the end, and stop the previous one in case this
+    // one did not read all of its input.
+    pipe.close_write();
+    if (in) {
+        in->close_read();
+    }
+
+    Guarded_Scheduler::exit();
+}
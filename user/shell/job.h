@@ -0,0 +1,90 @@
+// vim: set et ts=4 sw=4:
+
+#pragma once
+
+#include "object/o_stream.h"
+#include "syscall/guarded_pipe.h"
+#include "thread/thread.h"
+#include "user/shell/shell.h"
+#include "user/string/string.h"
+
+// Collects the output of a background job instead of printing it, so that it
+// does not mix with the line the user is typing. Only the job writes into it;
+// the shell prints the text once the job has been reaped.
+class Job_Stream : public Buffered_O_Stream<80> {
+    Job_Stream(const Job_Stream&)            = delete;
+    Job_Stream& operator=(const Job_Stream&) = delete;
+
+public:
+    static const size_t CAPACITY = 2048;
+
+private:
+    char text[CAPACITY];
+    size_t len;
+    bool truncated;
+
+public:
+    Job_Stream() : len(0), truncated(false) {}
+
+    void flush() override;
+
+    using O_Stream::operator<<;
+
+    // the captured text has no colors.
+    O_Stream& operator <<(CGA_Screen::Attribute& attr) override {
+        (void) attr;
+        return *this;
+    }
+
+    StringView output() const { return StringView(text, len); }
+
+    // true if output was dropped because the capture was full.
+    bool was_truncated() const { return truncated; }
+};
+
+// A command started with a trailing '&'. It runs in its own thread on a copy
+// of its command line, so the shell can reuse its input buffer right away.
+//
+// The thread stays a zombie when it exits or is killed, until the shell has
+// seen that it is dead() and deletes it (see Shell::reap_jobs()).
+class Job final : public Thread {
+    Job(const Job&)            = delete;
+    Job& operator=(const Job&) = delete;
+
+    Shell &shell;
+    Shell::Handler handler;
+
+public:
+    const unsigned id;
+    const String line;
+    Job_Stream out;
+
+    Job(unsigned id, Shell &shell, Shell::Handler handler, const StringView& line)
+        : Thread(), shell(shell), handler(handler), id(id), line(line) {}
+
+    void action() override;
+};
+
+// One command of a pipeline "a | b | c". Every stage runs in its own thread,
+// reads the output of the previous stage (if any) and writes into its own
+// pipe, which the next stage or, for the last one, the shell reads. The
+// command line stays valid, as the shell waits for the whole pipeline.
+class Pipe_Stage final : public Thread {
+    Pipe_Stage(const Pipe_Stage&)            = delete;
+    Pipe_Stage& operator=(const Pipe_Stage&) = delete;
+
+    Shell &shell;
+    Shell::Handler handler;
+    StringView line;
+    Guarded_Pipe *in;
+    Guarded_Pipe &pipe;
+    Pipe_Stream out;
+
+public:
+    Pipe_Stage(Shell &shell, Shell::Handler handler, const StringView& line,
+               Guarded_Pipe *in, Guarded_Pipe &pipe)
+        : Thread(), shell(shell), handler(handler), line(line), in(in), pipe(pipe),
+          out(pipe) {}
+
+    void action() override;
+};
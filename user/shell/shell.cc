@@ -1,47 +1,36 @@
 #include "user/shell/shell.h"
+#include "user/shell/job.h"
 #include "debug/output.h"
 #include "syscall/guarded_keyboard.h"
 #include "syscall/guarded_bell.h"
 #include "user/time/rtc.h"
+#include "machine/clock.h"
+#include "utils/math.h"
 #include "machine/cgascr.h"
 #include "object/queue.h"
+#include "device/console.h"
+#include "object/format.h"
+#include "syscall/guarded_scheduler.h"
 
-static CGA_Screen::Pixel *base = CGA_Screen::CGA_BASE;
 static CGA_Screen::Pixel *backup_cga;
 static int backup_out_x, backup_out_y;
 
 static String prompt("$ ");
 
-void Shell::screen_backup(CGA_Stream& str) {
-    for (int x = str.from_col; x <= str.to_col; x++) {
-        for (int y = str.from_row; y <= str.to_row; y++) {
-            backup_cga[y * str.COLUMNS + x] = base[y * str.COLUMNS + x];
-        }
-    }
-}
-
-void Shell::screen_restore(CGA_Stream& str) {
-    for (int x = str.from_col; x <= str.to_col; x++) {
-        for (int y = str.from_row; y <= str.to_row; y++) {
-            base[y * str.COLUMNS + x] = backup_cga[y * str.COLUMNS + x];
-        }
-    }
-}
-
 void Shell::backup() {
     if (!backup_cga) {
-        backup_cga = new CGA_Screen::Pixel[CGA_Screen::ROWS * CGA_Screen::COLUMNS];
+        backup_cga = new CGA_Screen::Pixel[out.width * out.height];
     }
 
     out.getpos(backup_out_x, backup_out_y);
-    screen_backup(out);
+    out.save(backup_cga);
 }
 
 void Shell::restore() {
     out.setpos(backup_out_x, backup_out_y);
-    screen_restore(out);
+    out.restore(backup_cga);
 
-    delete backup_cga;
+    delete[] backup_cga;
     backup_cga = nullptr;
 }
 
@@ -69,7 +58,7 @@ void Shell::history_add(String *str) {
     }
 }
 
-void Shell::perror(String cmd, char *error) const {
+void Shell::perror(const StringView& cmd, const char *error) const {
     out << cmd << ": " << error << endl;
 }
 
@@ -161,6 +150,16 @@ size_t Shell::read(String *str, size_t count) {
                 cursor++;
             }
         } break;
+
+        // shift + page up/down browses the scrollback.
+        case Key::scan::pgup:
+        case Key::scan::pgdn: {
+            if (k.SHIFT()) {
+                int lines = out.height / 2;
+                out.scroll(k.scancode() == Key::scan::pgup ? lines : -lines);
+                continue;
+            }
+        } break;
         } // switch (k.scancode())
 
         // catch backspace.
@@ -245,131 +244,268 @@ size_t Shell::read(String *str, size_t count) {
     return str->length();
 }
 
-void Shell::process_input(String *str) {
-    str->remove_lf();
-    if (str->empty()) {
-        return;
+Shell::Command Shell::commands[MAX_COMMANDS];
+size_t Shell::num_commands;
+uint8_t Shell::table[TABLE_SIZE];
+
+void Shell_Context::error(const char *error) {
+    out << name << ": " << error << endl;
+}
+
+size_t Shell_Context::read(char *buf, size_t len) {
+    return in ? in->read(buf, len) : 0;
+}
+
+bool Shell_Context::output_closed() {
+    return pipe_out && pipe_out->closed();
+}
+
+// FNV-1a
+uint32_t Shell::hash(const StringView& name) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < name.length(); i++) {
+        h ^= (uint8_t) name[i];
+        h *= 16777619u;
     }
+    return h;
+}
 
-    history_add(str);
+bool Shell::register_command(const char *name, Handler handler, const char *help) {
+    static_assert(MAX_COMMANDS < 256, "table entries are only one byte");
+    static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0, "TABLE_SIZE must be a power of two");
+
+    if (num_commands == MAX_COMMANDS || find(name)) {
+        return false;
+    }
+
+    // linear probing; there is always a free slot, as the table is at most half full.
+    size_t slot = hash(name) & (TABLE_SIZE - 1);
+    while (table[slot] != 0) {
+        slot = (slot + 1) & (TABLE_SIZE - 1);
+    }
+
+    commands[num_commands] = { name, handler, help };
+    table[slot] = ++num_commands;
+    return true;
+}
+
+const Shell::Command *Shell::find(const StringView& name) {
+    for (size_t slot = hash(name) & (TABLE_SIZE - 1); table[slot] != 0;
+         slot = (slot + 1) & (TABLE_SIZE - 1)) {
+        const Command *c = &commands[table[slot] - 1];
+        if (streq(name, c->name)) {
+            return c;
+        }
+    }
+    return nullptr;
+}
+
+void Shell::list_commands(O_Stream &out) {
+    // list the commands in alphabetical order, without sorting the table.
+    const char *last = nullptr;
+    for (size_t n = 0; n < num_commands; n++) {
+        const Command *next = nullptr;
+        for (size_t i = 0; i < num_commands; i++) {
+            const Command *c = &commands[i];
+            if ((!last || strcmp(c->name, last) > 0)
+                && (!next || strcmp(c->name, next->name) < 0)) {
+                next = c;
+            }
+        }
+        format(out, FMT("{:<10} {}\n"), next->name, next->help);
+        last = next->name;
+    }
+    out << flush;
+}
+
+bool Shell::start_job(Handler handler, const StringView& line) {
+    reap_jobs();
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        if (!jobs[i]) {
+            jobs[i] = new Job(next_job_id++, *this, handler, line);
+            out << '[' << jobs[i]->id << "] " << jobs[i]->line << endl;
+            Guarded_Scheduler::ready(jobs[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Shell::reap_job(size_t slot) {
+    Job *job = jobs[slot];
+    out << '[' << job->id << "] " << (job->exit_code() == Thread::KILLED ? "killed" : "done") << "  "
+        << job->line << endl << job->out.output();
+    if (job->out.was_truncated()) {
+        out << "(output truncated)" << endl;
+    }
+    out << flush;
+
+    jobs[slot] = nullptr;
+    delete job;
+}
+
+void Shell::reap_jobs() {
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i] && Guarded_Scheduler::dead(jobs[i])) {
+            reap_job(i);
+        }
+    }
+}
+
+void Shell::list_jobs() {
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i]) {
+            format(out, FMT("[{}] {:<7}  {}\n"), jobs[i]->id,
+                   Guarded_Scheduler::dead(jobs[i]) ? "done" : "running", jobs[i]->line);
+        }
+    }
+    out << flush;
+}
+
+Job *Shell::find_job(unsigned id) {
+    Job *found = nullptr;
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        Job *job = jobs[i];
+        if (job && (id == 0 ? (!found || job->id > found->id) : job->id == id)) {
+            found = job;
+        }
+    }
+    return found;
+}
 
-    String cmd = str->tok(" ");
-    if (streq(cmd, "test")) {
-        out << COLOR_GREEN << "success :)" << COLOR_RESET << endl;
-        /*String s("hallo welt");
-        out << s.substr(4, 5) << endl;
-        out << s.erase(2, 4) << endl;
-        String a = s.tok(" ");
-        String b = s.tok(" ");
-        out << a << endl;
-        out << b << endl;*/
-    } else if (streq(cmd, "yes")) {
-        out << COLOR_YELLOW << "no" << COLOR_RESET << endl;
-    } else if (streq(cmd, "time") || streq(cmd, "date")) {
-        out << rtc << endl;
-    } else if (streq(cmd, "cpu0")) {
-        dout_CPU0 << "sup bitch" << endl;
-    } else if (streq(cmd, "cpu1")) {
-        dout_CPU1 << "sup bitch" << endl;
-    } else if (streq(cmd, "cpu2")) {
-        dout_CPU2 << "sup bitch" << endl;
-    } else if (streq(cmd, "cpu3")) {
-        dout_CPU3 << "sup bitch" << endl;
-    } else if (streq(cmd, "reboot") || streq(cmd, "restart")) {
-        keyboard.reboot();
-    } else if (streq(cmd, "nullptr")) {
-        out << "nullptr: " << (void *) nullptr << endl;
-    } else if (streq(cmd, "hex")) {
-        out << hex << -1 << dec << endl;
-    } else if (streq(cmd, "strtol")) {
-        String num = str->tok(" ");
-        String tmp = str->tok(" ");
-        bool error;
-        int base = strtol(tmp, &error);
-        if (!tmp.empty() && error) {
-            out << "base invalid, using autodetect" << endl;
-            base = 0;
+void Shell::kill_job(Job *job) {
+    Guarded_Scheduler::kill(job);
+}
+
+void Shell::wait_job(Job *job) {
+    Guarded_Scheduler::join(job);
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i] == job) {
+            reap_job(i);
         }
+    }
+}
 
-        out << strtol(num, &error, base) << (error ? " (error!)" : "") << endl;
-    } else if (streq(cmd, "strtok")) {
-        String arg;
-        while (!(arg = str->tok(" ")).empty()) {
-            out << arg << endl;
+void Shell::kill_jobs() {
+    for (size_t i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i]) {
+            kill_job(jobs[i]);
+            wait_job(jobs[i]);
         }
-    } else if (streq(cmd, "strcmp")) {
-        String str1 = str->tok(" ");
-        String str2 = str->tok(" ");
-        if (str1.empty() || str2.empty()) {
-            perror(cmd, "usage: strcmp <str1> <str2>");
+    }
+}
+
+void Shell::run_pipeline(const StringView& line) {
+    // look up all commands before starting anything.
+    StringView lines[MAX_STAGES];
+    Handler handlers[MAX_STAGES];
+    size_t n = 0;
+
+    for (StringView rest = line;;) {
+        size_t bar = rest.find_first_of('|');
+        StringView stage = rest.substr(0, bar);
+        StringView args = stage;
+        StringView name = args.tok(" ");
+
+        if (name.empty()) {
+            perror("|", "missing command");
+            return;
+        }
+        if (n == MAX_STAGES) {
+            perror("|", "too many commands");
             return;
         }
-        out << "result of comparison: " << strcmp(str1, str2) << endl;
-    } else if (streq(cmd, "insert")) {
-        String s     = str->tok(" ");
-        String ins   = str->tok(" ");
-        String pos_s = str->tok(" ");
-        if (s.empty() || ins.empty()) {
-            perror(cmd, "usage: insert <str> <insert_str> <pos>");
+        const Command *c = find(name);
+        if (!c) {
+            perror(name, "command not found");
             return;
         }
+        lines[n] = stage;
+        handlers[n++] = c->handler;
 
-        long pos = strtol(pos_s);
-        out << "inserting " << ins << " into " << s << " at " << pos << ":" << endl
-            << s.insert(pos, ins) << endl;
-    } else if (streq(cmd, "set")) {
-        String subcmd = str->tok(" ");
-
-        if (streq(subcmd, "time")) {
-            String hour_s   = str->tok(" :/-,.");
-            String minute_s = str->tok(" :/-,.");
-            String second_s = str->tok(" :/-,.");
-            if (hour_s.empty() || minute_s.empty() || second_s.empty()) {
-                perror(cmd, "usage: set time <hour> <minute> <second>");
-                return;
-            }
+        if (bar == StringView::npos) {
+            break;
+        }
+        rest = rest.substr(bar + 1);
+    }
 
-            Secure s;
-            rtc.set_local_hour(strtol(hour_s));
-            rtc.set_minute(strtol(minute_s));
-            rtc.set_second(strtol(second_s));
+    Guarded_Pipe *pipes[MAX_STAGES];
+    Pipe_Stage *stages[MAX_STAGES];
+    for (size_t i = 0; i < n; i++) {
+        pipes[i] = new Guarded_Pipe();
+        stages[i] = new Pipe_Stage(*this, handlers[i], lines[i],
+                                   i ? pipes[i - 1] : nullptr, *pipes[i]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        Guarded_Scheduler::ready(stages[i]);
+    }
 
-            rtc.update_time();
-        } else if (streq(subcmd, "timezone")) {
-            String zone_s = str->tok(" ");
-            if (zone_s.empty()) {
-                out << "current timezone: " << rtc.timezone << endl;
-                return;
-            }
+    // print the output of the last stage while the pipeline is running.
+    char buf[128];
+    size_t len;
+    while ((len = pipes[n - 1]->read(buf, sizeof(buf))) != 0) {
+        out << StringView(buf, len) << flush;
+    }
 
-            Secure s;
-            rtc.set_timezone(strtol(zone_s));
-
-            rtc.update_time();
-        } else if (streq(subcmd, "date")) {
-            String day_s     = str->tok(" :/-,.");
-            String month_s   = str->tok(" :/-,.");
-            String year_s    = str->tok(" :/-,.");
-            String weekday_s = str->tok(" :/-,.");
-            if (day_s.empty() || month_s.empty() || year_s.empty()) {
-                perror(cmd, "usage: set date <day> <month> <year> [<numeric weekday>]");
-                return;
-            }
+    for (size_t i = 0; i < n; i++) {
+        Guarded_Scheduler::join(stages[i]);
+        delete stages[i];
+        delete pipes[i];
+    }
+}
 
-            Secure s;
-            rtc.set_day(strtol(day_s));
-            rtc.set_month(strtol(month_s));
-            rtc.set_real_year(strtol(year_s));
-            if (!weekday_s.empty()) {
-                rtc.set_weekday(strtol(weekday_s));
-            }
+// Removes a trailing '&' (and the blanks around it) from "line".
+static bool strip_background(StringView& line) {
+    size_t len = line.length();
+    while (len > 0 && line[len - 1] == ' ') {
+        len--;
+    }
+    if (len == 0 || line[len - 1] != '&') {
+        return false;
+    }
+
+    len--;
+    while (len > 0 && line[len - 1] == ' ') {
+        len--;
+    }
+    line = line.substr(0, len);
+    return true;
+}
+
+void Shell::process_input(String *str) {
+    str->remove_lf();
+    if (str->empty()) {
+        return;
+    }
+
+    history_add(str);
+
+    // all tokens are views into "str", so parsing does not allocate.
+    StringView line(*str);
+    bool background = strip_background(line);
 
-            rtc.update_time();
+    if (line.find_first_of('|') != StringView::npos) {
+        if (background) {
+            perror("|", "pipelines cannot run in the background");
         } else {
-            perror(cmd, "usage: set <time|timezone|date>");
+            run_pipeline(line);
         }
-    } else {
-        perror(cmd, "command not found");
+        return;
+    }
+
+    Shell_Context ctx = { *this, out, StringView(), line, false, nullptr, nullptr };
+    ctx.name = ctx.args.tok(" ");
+
+    const Command *c = find(ctx.name);
+    if (!c) {
+        perror(ctx.name, "command not found");
+        return;
+    }
+
+    if (!background) {
+        c->handler(ctx);
+    } else if (!start_job(c->handler, line)) {
+        perror(ctx.name, "too many jobs");
     }
 }
 
@@ -378,19 +514,313 @@ void Shell::start() {
     out.reset();
     out << COLOR_GREEN << "Welcome to bsh (Best SHell)! " << (char) 1 << COLOR_RESET << endl;
 
+    // reused for every command, so that reading one does not allocate.
+    String str;
+    str.reserve(512 + 1);
+
     for (;;) {
+        reap_jobs();
         out << COLOR_WHITE << prompt << COLOR_RESET << flush;
 
-        String *str = new String;
-        if (!read(str, 512)) {
-            delete str;
+        if (!read(&str, 512)) {
             break;
         }
 
-        process_input(str);
-        delete str;
+        process_input(&str);
     }
 
+    kill_jobs();
     history_destroy();
     restore();
 }
+
+/// Builtin commands
+
+SHELL_COMMAND(help, "lists all commands") {
+    Shell::list_commands(ctx.out);
+}
+
+SHELL_COMMAND(test, "prints a success message") {
+    ctx.out << COLOR_GREEN << "success :)" << COLOR_RESET << endl;
+}
+
+SHELL_COMMAND(yes, "answers") {
+    ctx.out << COLOR_YELLOW << "no" << COLOR_RESET << endl;
+}
+
+SHELL_COMMAND(time, "prints the current time and date") {
+    ctx.out << rtc.now() << endl;
+}
+static Shell_Command_Registrar shell_registrar_date("date", shell_command_time,
+                                                    "prints the current time and date");
+
+SHELL_COMMAND(uptime, "prints the time since boot and the TSC frequency") {
+    uint64_t rem;
+    uint64_t ns = Clock::now_ns();
+    unsigned secs = (unsigned) Math::div64(ns, 1000000000, &rem);
+    format(ctx.out, FMT("up {}.{:06} s, TSC at {} kHz{}\n"), secs,
+           (unsigned) Math::div64(rem, 1000), Clock::tsc_khz(),
+           Clock::invariant() ? " (invariant)" : "");
+}
+
+// job control works on the job table of the shell, which only the thread of
+// the shell itself may touch.
+static bool foreground(Shell_Context &ctx) {
+    if (ctx.background) {
+        ctx.error("cannot run in the background");
+    }
+    return !ctx.background;
+}
+
+SHELL_COMMAND(jobs, "lists the background jobs") {
+    if (foreground(ctx)) {
+        ctx.shell.reap_jobs();
+        ctx.shell.list_jobs();
+    }
+}
+
+// the job given as first argument, or the most recent one.
+static Job *job_arg(Shell_Context &ctx) {
+    StringView id_s = ctx.args.tok(" ");
+    bool error = false;
+    long id = id_s.empty() ? 0 : strtol(id_s, &error);
+    Job *job = (error || id < 0) ? nullptr : ctx.shell.find_job(id);
+    if (!job) {
+        ctx.error("no such job");
+    }
+    return job;
+}
+
+SHELL_COMMAND(kill, "<id>: kills a background job") {
+    if (!foreground(ctx)) {
+        return;
+    }
+    if (ctx.args.empty()) {
+        ctx.error("usage: kill <id>");
+    } else if (Job *job = job_arg(ctx)) {
+        ctx.shell.kill_job(job);
+    }
+}
+
+SHELL_COMMAND(fg, "[<id>]: waits for a background job and prints its output") {
+    if (!foreground(ctx)) {
+        return;
+    }
+    if (Job *job = job_arg(ctx)) {
+        ctx.shell.wait_job(job);
+    }
+}
+
+SHELL_COMMAND(wait, "waits for all background jobs") {
+    if (!foreground(ctx)) {
+        return;
+    }
+    while (Job *job = ctx.shell.find_job(0)) {
+        ctx.shell.wait_job(job);
+    }
+}
+
+static void greet(CGA_Stream &out) {
+    out << "sup bitch" << endl;
+}
+
+SHELL_COMMAND(cpu0, "greets in the debug window of CPU 0") { greet(dout_CPU0); }
+SHELL_COMMAND(cpu1, "greets in the debug window of CPU 1") { greet(dout_CPU1); }
+SHELL_COMMAND(cpu2, "greets in the debug window of CPU 2") { greet(dout_CPU2); }
+SHELL_COMMAND(cpu3, "greets in the debug window of CPU 3") { greet(dout_CPU3); }
+
+SHELL_COMMAND(reboot, "restarts the machine") {
+    keyboard.reboot();
+}
+static Shell_Command_Registrar shell_registrar_restart("restart", shell_command_reboot,
+                                                       "restarts the machine");
+
+SHELL_COMMAND(nullptr, "prints a null pointer") {
+    ctx.out << "nullptr: " << (void *) nullptr << endl;
+}
+
+SHELL_COMMAND(hex, "prints -1 in hex") {
+    ctx.out << hex << -1 << dec << endl;
+}
+
+SHELL_COMMAND(strtol, "<num> [<base>]: parses a number") {
+    StringView num = ctx.args.tok(" ");
+    StringView tmp = ctx.args.tok(" ");
+    bool error;
+    int base = strtol(tmp, &error);
+    if (!tmp.empty() && error) {
+        ctx.out << "base invalid, using autodetect" << endl;
+        base = 0;
+    }
+
+    ctx.out << strtol(num, &error, base) << (error ? " (error!)" : "") << endl;
+}
+
+SHELL_COMMAND(strtok, "<args...>: prints one argument per line") {
+    StringView arg;
+    while (!(arg = ctx.args.tok(" ")).empty()) {
+        ctx.out << arg << endl;
+    }
+}
+
+SHELL_COMMAND(strcmp, "<str1> <str2>: compares two strings") {
+    StringView str1 = ctx.args.tok(" ");
+    StringView str2 = ctx.args.tok(" ");
+    if (str1.empty() || str2.empty()) {
+        ctx.error("usage: strcmp <str1> <str2>");
+        return;
+    }
+    ctx.out << "result of comparison: " << strcmp(str1, str2) << endl;
+}
+
+// Calls "f" for every line of the input, without its '\n', until f returns
+// false.
+template <typename F>
+static void for_each_line(Shell_Context &ctx, F f) {
+    char buf[128];
+    size_t len;
+    String line;
+    while (!ctx.output_closed() && (len = ctx.read(buf, sizeof(buf))) != 0) {
+        for (size_t i = 0; i < len; i++) {
+            if (buf[i] != '\n') {
+                line.append(buf[i]);
+            } else if (!f(StringView(line))) {
+                return;
+            } else {
+                line.clear();
+            }
+        }
+    }
+    if (!line.empty()) {
+        f(StringView(line));
+    }
+}
+
+SHELL_COMMAND(seq, "<n>: prints the numbers from 1 to n") {
+    bool error;
+    long n = strtol(ctx.args.tok(" "), &error);
+    if (error) {
+        ctx.error("usage: seq <n>");
+        return;
+    }
+    for (long i = 1; i <= n && !ctx.output_closed(); i++) {
+        ctx.out << i << '\n';
+    }
+    ctx.out << flush;
+}
+
+SHELL_COMMAND(grep, "<str>: prints the input lines containing str") {
+    StringView pattern = ctx.args.tok(" ");
+    if (pattern.empty()) {
+        ctx.error("usage: grep <str>");
+        return;
+    }
+    for_each_line(ctx, [&](const StringView& line) {
+        if (line.find(pattern) != StringView::npos) {
+            ctx.out << line << '\n';
+        }
+        return true;
+    });
+    ctx.out << flush;
+}
+
+SHELL_COMMAND(head, "[<n>]: prints the first n (10) input lines") {
+    StringView n_s = ctx.args.tok(" ");
+    bool error = false;
+    long n = n_s.empty() ? 10 : strtol(n_s, &error);
+    if (error) {
+        ctx.error("usage: head [<n>]");
+        return;
+    }
+    if (n > 0) {
+        for_each_line(ctx, [&](const StringView& line) {
+            ctx.out << line << '\n';
+            return --n > 0;
+        });
+    }
+    ctx.out << flush;
+}
+
+SHELL_COMMAND(wc, "counts the lines, words and bytes of the input") {
+    char buf[128];
+    size_t len;
+    unsigned lines = 0, words = 0, bytes = 0;
+    bool in_word = false;
+    while ((len = ctx.read(buf, sizeof(buf))) != 0) {
+        for (size_t i = 0; i < len; i++) {
+            bool space = buf[i] == ' ' || buf[i] == '\t' || buf[i] == '\n';
+            words += !space && !in_word;
+            in_word = !space;
+            lines += buf[i] == '\n';
+        }
+        bytes += len;
+    }
+    format(ctx.out, FMT("{} {} {}\n"), lines, words, bytes) << flush;
+}
+
+SHELL_COMMAND(insert, "<str> <insert_str> <pos>: inserts into a string") {
+    String s(ctx.args.tok(" "));
+    StringView ins   = ctx.args.tok(" ");
+    StringView pos_s = ctx.args.tok(" ");
+    if (s.empty() || ins.empty()) {
+        ctx.error("usage: insert <str> <insert_str> <pos>");
+        return;
+    }
+
+    long pos = strtol(pos_s);
+    ctx.out << "inserting " << ins << " into " << s << " at " << pos << ":" << endl
+            << s.insert(pos, String(ins)) << endl;
+}
+
+SHELL_COMMAND(set, "<time|timezone|date> ...: sets the clock") {
+    StringView subcmd = ctx.args.tok(" ");
+
+    if (streq(subcmd, "time")) {
+        StringView hour_s   = ctx.args.tok(" :/-,.");
+        StringView minute_s = ctx.args.tok(" :/-,.");
+        StringView second_s = ctx.args.tok(" :/-,.");
+        if (hour_s.empty() || minute_s.empty() || second_s.empty()) {
+            ctx.error("usage: set time <hour> <minute> <second>");
+            return;
+        }
+
+        Secure s;
+        rtc.set_local_hour(strtol(hour_s));
+        rtc.set_minute(strtol(minute_s));
+        rtc.set_second(strtol(second_s));
+
+        rtc.resync();
+    } else if (streq(subcmd, "timezone")) {
+        StringView zone_s = ctx.args.tok(" ");
+        if (zone_s.empty()) {
+            ctx.out << "current timezone: " << rtc.get_timezone() << endl;
+            return;
+        }
+
+        Secure s;
+        rtc.set_timezone(strtol(zone_s));
+
+        rtc.resync();
+    } else if (streq(subcmd, "date")) {
+        StringView day_s     = ctx.args.tok(" :/-,.");
+        StringView month_s   = ctx.args.tok(" :/-,.");
+        StringView year_s    = ctx.args.tok(" :/-,.");
+        StringView weekday_s = ctx.args.tok(" :/-,.");
+        if (day_s.empty() || month_s.empty() || year_s.empty()) {
+            ctx.error("usage: set date <day> <month> <year> [<numeric weekday>]");
+            return;
+        }
+
+        Secure s;
+        rtc.set_day(strtol(day_s));
+        rtc.set_month(strtol(month_s));
+        rtc.set_real_year(strtol(year_s));
+        if (!weekday_s.empty()) {
+            rtc.set_weekday(strtol(weekday_s));
+        }
+
+        rtc.resync();
+    } else {
+        ctx.error("usage: set <time|timezone|date>");
+    }
+}
@@ -5,12 +5,74 @@
 #include "utils/heap.h"
 #include "machine/key.h"
 
+class Shell;
+class Job;
+class Guarded_Pipe;
+class Pipe_Stream;
+
+// Everything a command handler gets: "name" is the command as typed, "args"
+// the rest of the line, from which the handler takes its arguments with
+// args.tok(). Commands started with '&' or in a pipeline run in their own
+// thread and write into the output capture of their job or into a pipe
+// instead of the shell window.
+struct Shell_Context {
+    Shell &shell;
+    O_Stream &out;
+    StringView name;
+    StringView args;
+    bool background;
+    Guarded_Pipe *in; // output of the previous pipeline stage, if any
+    Pipe_Stream *pipe_out; // "out" if it goes to the next stage
+
+    // true once the next pipeline stage has stopped reading, e.g. "head".
+    // Commands writing a lot of output should stop then.
+    bool output_closed();
+
+    // Prints "<name>: <error>".
+    void error(const char *error);
+
+    // Reads up to "len" bytes of input. Returns 0 at its end, and right away
+    // for a command that is not in a pipeline.
+    size_t read(char *buf, size_t len);
+};
+
 class Shell {
+public:
+    typedef void (*Handler)(Shell_Context &ctx);
+
+    // Maximum number of commands, and size of the (open addressing) hash
+    // table, which is kept at most half full.
+    static const size_t MAX_COMMANDS = 64;
+    static const size_t TABLE_SIZE   = 2 * MAX_COMMANDS;
+
 private:
+    struct Command {
+        const char *name;
+        Handler handler;
+        const char *help;
+    };
+
+    // filled by static constructors, so both are plain arrays.
+    static Command commands[MAX_COMMANDS];
+    static size_t num_commands;
+    static uint8_t table[TABLE_SIZE]; // index into commands + 1, 0 is empty
+
+    static uint32_t hash(const StringView& name);
+    static const Command *find(const StringView& name);
+
     CGA_Stream &out;
 
-    void screen_backup(CGA_Stream& str);
-    void screen_restore(CGA_Stream& str);
+    // Background jobs; only the thread of the shell touches this table.
+    static const size_t MAX_JOBS = 8;
+    Job *jobs[MAX_JOBS];
+    unsigned next_job_id;
+
+    static const size_t MAX_STAGES = 4;
+
+    bool start_job(Handler handler, const StringView& line);
+    void run_pipeline(const StringView& line);
+    void reap_job(size_t slot);
+    void kill_jobs();
 
     void backup();
     void restore();
@@ -35,12 +97,47 @@ private:
     void history_add(String *str);
 
 public:
-    Shell(CGA_Stream &out) : out(out), history_tail(nullptr) {}
+    Shell(CGA_Stream &out) : out(out), jobs(), next_job_id(1), history_tail(nullptr) {}
+
+    // Adds a command, usually through SHELL_COMMAND. "name" and "help" are
+    // not copied. Returns false if the name is taken or the table is full.
+    static bool register_command(const char *name, Handler handler, const char *help);
 
-    void perror(String cmd, char *error) const;
+    // Prints all commands with their help texts, sorted by name.
+    static void list_commands(O_Stream &out);
+
+    void perror(const StringView& cmd, const char *error) const;
+
+    // Job control, for the commands jobs, kill, fg and wait. Reaping a dead
+    // job prints its output and deletes it.
+    void reap_jobs();
+    void list_jobs();
+    // id 0 finds the most recent job; nullptr if there is none.
+    Job *find_job(unsigned id);
+    void kill_job(Job *job);
+    // blocks until the job is dead, then reaps it.
+    void wait_job(Job *job);
 
     size_t read(String *str, size_t count);
     void process_input(String *str);
 
     void start();
 };
+
+struct Shell_Command_Registrar {
+    Shell_Command_Registrar(const char *name, Shell::Handler handler, const char *help) {
+        bool ok = Shell::register_command(name, handler, help);
+        assert(ok);
+        (void) ok;
+    }
+};
+
+// Defines a handler and registers it as "NAME" when the kernel starts:
+//
+//     SHELL_COMMAND(yes, "prints no") {
+//         ctx.out << "no" << endl;
+//     }
+#define SHELL_COMMAND(NAME, HELP) \
+    static void shell_command_##NAME(Shell_Context &ctx); \
+    static Shell_Command_Registrar shell_registrar_##NAME(#NAME, shell_command_##NAME, HELP); \
+    static void shell_command_##NAME(__attribute__((unused)) Shell_Context &ctx)
@@ -6,31 +6,37 @@
 
 #pragma once
 
-#include "thread/thread.h"
+#include "syscall/guarded_timer.h"
 #include "debug/output.h"
 
-/*! \brief Die Klasse Application definiert eine Anwendung für OO-Stubs.
+/*! \brief Die Klasse StatusApplication zeigt in der Statuszeile die
+ *  untätigen CPUs, die Anzahl der Threads und die Belegung des Heaps an.
+ *
+ *  Sie braucht dafür keinen eigenen Thread: ein periodischer Timer
+ *  aktualisiert die Anzeige zehnmal pro Sekunde im Epilog.
  */
-class StatusApplication : public Thread {
+class StatusApplication {
 	// Verhindere Kopien und Zuweisungen
 	StatusApplication(const StatusApplication&)            = delete;
 	StatusApplication& operator=(const StatusApplication&) = delete;
 
 private:
 	int id;
+	Guarded_Timer timer;
+
+	static void update(void *app);
 
 public:
 	/*! \brief Konstruktor
 	 *
 	 * \param i Instanz-ID
 	 */
-    StatusApplication(void *tos, int i = 0) : Thread(tos), id(i) {}
-    StatusApplication(int i = 0) : Thread(), id(i) {}
+    StatusApplication(int i = 0) : id(i), timer(update, this) {}
 
-	/*! \brief Enthält den Code der Anwendung
+	/*! \brief Startet die periodische Aktualisierung der Anzeige.
 	 *
 	 */
-	void action() override;
+	void start();
 
     /*! \brief Setzt eine Instanz-ID
      *
@@ -6,18 +6,79 @@
 
 #define used_data (use_heap ? data : short_data)
 
+// The scanning functions below look at a whole word at a time. A word "x"
+// contains a zero byte iff (x - 0x01..01) & ~x & 0x80..80 is nonzero; to
+// search for a byte "c", the word is xor'ed with "c" repeated in every byte.
+typedef unsigned long word;
+typedef word __attribute__((may_alias)) aliased_word;
+typedef word __attribute__((may_alias, aligned(1))) unaligned_word;
+
+static const word ONES  = (word)-1 / 0xff;
+static const word HIGHS = ONES * 0x80;
+
+static inline bool has_zero(word x) {
+    return ((x - ONES) & ~x & HIGHS) != 0;
+}
+
+static inline word load(const char *p) {
+    return *(const unaligned_word *) p;
+}
+
+// Index of the first byte where "a" and "b" differ, or "len".
+// Not inlined, as gcc then warns about word loads from short literals, even
+// though those are never executed.
+static __attribute__((noinline)) size_t mismatch(const char *a, const char *b, size_t len) {
+    size_t i = 0;
+    while (i + sizeof(word) <= len && load(a + i) == load(b + i)) {
+        i += sizeof(word);
+    }
+    while (i < len && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+// 256-bit membership bitmap of a set of chars.
+class Char_Set {
+    uint32_t bits[8];
+
+public:
+    Char_Set(const StringView& chars) : bits() {
+        for (size_t i = 0; i < chars.length(); i++) {
+            uint8_t c = chars[i];
+            bits[c / 32] |= 1u << (c % 32);
+        }
+    }
+
+    bool contains(char c) const {
+        uint8_t u = c;
+        return bits[u / 32] & (1u << (u % 32));
+    }
+};
+
 String::String() : use_heap(false), len(0), save_index(0) {}
 
-String::String(char *s) : use_heap(false), len(0), save_index(0) {
-    for (char *c = s; *c != '\0'; c++) {
+String::String(const char *s) : use_heap(false), len(0), save_index(0) {
+    for (const char *c = s; *c != '\0'; c++) {
         append(*c);
     }
 }
 
+String::String(const StringView& str) : use_heap(false), len(0), save_index(0) {
+    reserve(str.length());
+    for (size_t i = 0; i < str.length(); i++) {
+        _append(str[i]);
+    }
+}
+
 String::String(const String& str) : use_heap(false), len(0), save_index(0) {
     append(str);
 }
 
+String::String(String&& str) : use_heap(false), len(0), save_index(0) {
+    steal(str);
+}
+
 String::~String() {
     if (use_heap) {
         free(data);
@@ -31,6 +92,32 @@ String& String::operator =(const String& str) {
     return *this;
 }
 
+String& String::operator =(String&& str) {
+    if (this != &str) {
+        if (use_heap) {
+            free(data);
+        }
+        steal(str);
+    }
+    return *this;
+}
+
+void String::steal(String& str) {
+    use_heap   = str.use_heap;
+    len        = str.len;
+    save_index = 0;
+    if (use_heap) {
+        data = str.data;
+        cap  = str.cap;
+    } else {
+        memcpy(short_data, str.short_data, len);
+    }
+
+    str.use_heap   = false;
+    str.len        = 0;
+    str.save_index = 0;
+}
+
 String::operator const char*() {
     _append_nullbyte();
     return used_data;
@@ -237,7 +324,7 @@ String& String::erase(size_t pos, size_t len) {
 
     String new_str = substr(0, pos);   // 1st part
     new_str.append(substr(pos + len)); // 2nd part
-    *this = new_str;
+    *this = static_cast<String&&>(new_str);
     return *this;
 }
 
@@ -265,49 +352,23 @@ void String::remove_lf() {
     }
 }
 
-bool String::compare(size_t pos, const String& str) const {
-    if (pos + str.length() > length()) {
-        return false;
-    }
-
-    for (size_t i = pos; i < Math::min(length(), str.length() + pos); i++) {
-        if (at(i) != str[i - pos]) {
-            return false;
-        }
-    }
-    return true;
+bool String::compare(size_t pos, const StringView& str) const {
+    return StringView(*this).compare(pos, str);
 }
 
-size_t String::find(const String& str, size_t pos) const {
-    for (size_t i = pos; i < length(); i++) {
-        if (compare(i, str)) {
-            return i;
-        }
-    }
-    return npos;
+size_t String::find(const StringView& str, size_t pos) const {
+    return StringView(*this).find(str, pos);
 }
 
 size_t String::find_first_of(char c, size_t pos) const {
-    for (size_t i = pos; i < length(); i++) {
-        if (at(i) == c) {
-            return i;
-        }
-    }
-    return npos;
+    return StringView(*this).find_first_of(c, pos);
 }
 
-size_t String::find_first_of(const String& str, size_t pos) const {
-    for (size_t i = pos; i < length(); i++) {
-        for (size_t j = 0; j < str.length(); j++) {
-            if (at(i) == str[j]) {
-                return i;
-            }
-        }
-    }
-    return npos;
+size_t String::find_first_of(const StringView& str, size_t pos) const {
+    return StringView(*this).find_first_of(str, pos);
 }
 
-String String::tok(const String& delim) {
+StringView String::tok(const StringView& delim) {
     return strtok(*this, delim);
 }
 
@@ -326,12 +387,44 @@ size_t String::copy(char *s, size_t len, size_t pos) const {
 
 size_t strlen(const char *s) {
     const char *p = s;
-    while (*p != '\0') {
-        p++;
+    for (; (uintptr_t) p % sizeof(word) != 0; p++) {
+        if (*p == '\0') {
+            return p - s;
+        }
     }
+
+    // an aligned word never crosses a page boundary, so reading past the end
+    // of the string is harmless.
+    const aliased_word *w = (const aliased_word *) p;
+    while (!has_zero(*w)) {
+        w++;
+    }
+    for (p = (const char *) w; *p != '\0'; p++);
     return p - s;
 }
 
+const char *memchr(const char *s, char c, size_t len) {
+    for (; len > 0 && (uintptr_t) s % sizeof(word) != 0; s++, len--) {
+        if (*s == c) {
+            return s;
+        }
+    }
+
+    const word pattern = ONES * (uint8_t) c;
+    for (; len >= sizeof(word); s += sizeof(word), len -= sizeof(word)) {
+        if (has_zero(*(const aliased_word *) s ^ pattern)) {
+            break;
+        }
+    }
+
+    for (; len > 0; s++, len--) {
+        if (*s == c) {
+            return s;
+        }
+    }
+    return nullptr;
+}
+
 char *strcpy(char *dest, const char *src) {
     return strncpy(dest, src, strlen(src));
 }
@@ -340,40 +433,136 @@ char *strncpy(char *dest, const char *src, size_t size) {
     return (char*)memcpy(dest, src, size);
 }
 
-int strcmp(const String& str1, const String& str2) {
-    for (size_t i = 0; i < Math::min(str1.length(), str2.length()); i++) {
-        if (str1[i] != str2[i]) {
-            return str1[i] - str2[i];
+StringView StringView::substr(size_t pos, size_t len) const {
+    if (pos >= length()) {
+        return StringView(ptr + length(), 0);
+    }
+    return StringView(ptr + pos, Math::min(len, length() - pos));
+}
+
+bool StringView::compare(size_t pos, const StringView& str) const {
+    // written like this to catch overflows of "pos + str.length()"
+    if (pos > length() || str.length() > length() - pos) {
+        return false;
+    }
+    return mismatch(ptr + pos, str.ptr, str.length()) == str.length();
+}
+
+// Boyer-Moore-Horspool: compare the last char of the window first and, on a
+// mismatch, shift the window so that the next occurrence of the char below
+// its end in "str" lines up with it.
+size_t StringView::find(const StringView& str, size_t pos) const {
+    size_t m = str.length();
+    if (pos >= length() || m > length() - pos) {
+        return npos;
+    }
+    if (m <= 1) {
+        return (m == 0) ? pos : find_first_of(str[0], pos);
+    }
+
+    // shifts are capped at 255, which only makes them smaller than allowed
+    uint8_t shift[256];
+    uint8_t max_shift = Math::min(m, (size_t) 255);
+    for (size_t i = 0; i < sizeof(shift); i++) {
+        shift[i] = max_shift;
+    }
+    for (size_t i = 0; i < m - 1; i++) {
+        size_t distance = m - 1 - i;
+        if (distance < max_shift) {
+            shift[(uint8_t) str[i]] = distance;
         }
     }
 
-    if (str1.length() != str2.length()) {
-        return (str1.length() > str2.length()) ? 1 : -1;
+    const char last = str[m - 1];
+    for (size_t i = pos; i <= length() - m; i += shift[(uint8_t) ptr[i + m - 1]]) {
+        if (ptr[i + m - 1] == last && mismatch(ptr + i, str.ptr, m - 1) == m - 1) {
+            return i;
+        }
     }
-    return 0;
+    return npos;
 }
 
-bool streq(const String& str1, const String& str2) {
-    return strcmp(str1, str2) == 0;
+size_t StringView::find_first_of(char c, size_t pos) const {
+    if (pos >= length()) {
+        return npos;
+    }
+    const char *found = memchr(ptr + pos, c, length() - pos);
+    return found ? found - ptr : npos;
 }
 
-String strtok(String& str, const String& delim) {
-    size_t pos;
+size_t StringView::find_first_of(const StringView& str, size_t pos) const {
+    if (str.length() == 1) {
+        return find_first_of(str[0], pos);
+    }
+
+    Char_Set set(str);
+    for (size_t i = pos; i < length(); i++) {
+        if (set.contains(ptr[i])) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+size_t StringView::find_first_not_of(const StringView& str, size_t pos) const {
+    Char_Set set(str);
+    for (size_t i = pos; i < length(); i++) {
+        if (!set.contains(ptr[i])) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+StringView StringView::tok(const StringView& delim) {
     // skip leading delimiting chars
-    while ((pos = str.find_first_of(delim, str.save_index)) == str.save_index) {
-        str.save_index++;
+    size_t start = find_first_not_of(delim);
+    if (start == npos) {
+        ptr += len;
+        len = 0;
+        return StringView(ptr, 0);
     }
-    if (pos == String::npos) {
+
+    size_t end = find_first_of(delim, start);
+    if (end == npos) {
         // no delimiting char could be found
-        pos = str.length();
+        end = length();
+    }
+
+    StringView ret(ptr + start, end - start);
+    size_t next = Math::min(end + 1, length());
+    ptr += next;
+    len -= next;
+    return ret;
+}
+
+int strcmp(const StringView& str1, const StringView& str2) {
+    size_t len = Math::min(str1.length(), str2.length());
+    size_t i = mismatch(str1.data(), str2.data(), len);
+    if (i < len) {
+        return str1[i] - str2[i];
     }
 
-    String ret = str.substr(str.save_index, pos - str.save_index);
-    str.save_index = pos + 1;
+    if (str1.length() != str2.length()) {
+        return (str1.length() > str2.length()) ? 1 : -1;
+    }
+    return 0;
+}
+
+bool streq(const StringView& str1, const StringView& str2) {
+    return str1.length() == str2.length() && str1.compare(0, str2);
+}
+
+StringView strtok(String& str, const StringView& delim) {
+    StringView rest = StringView(str).substr(str.save_index);
+    size_t old_length = rest.length();
+
+    StringView ret = rest.tok(delim);
+    str.save_index += old_length - rest.length();
     return ret;
 }
 
-long strtol(const String& str, bool *error, int base) {
+long strtol(const StringView& str, bool *error, int base) {
     // initialize error in case of empty input
     if (error) {
         *error = true;
@@ -2,6 +2,47 @@
 
 #include "types.h"
 
+class String;
+
+size_t strlen(const char *s);
+
+// Non-owning view of "len" chars starting at "ptr", which need not be
+// null-terminated. A view into a String is only valid as long as the String
+// is not modified or destroyed.
+class StringView {
+    const char *ptr;
+    size_t len;
+
+public:
+    static const size_t npos = (size_t)-1;
+
+    StringView() : ptr(""), len(0) {}
+    StringView(const char *s) : ptr(s), len(strlen(s)) {}
+    StringView(const char *s, size_t len) : ptr(s), len(len) {}
+    StringView(const String& str);
+
+    const char *data() const { return ptr; }
+    size_t length() const { return len; }
+    bool empty() const { return len == 0; }
+
+    char operator [](size_t i) const { return ptr[i]; }
+
+    StringView substr(size_t pos = 0, size_t len = npos) const;
+
+    // Compare this view, starting at "pos", with "str".
+    bool compare(size_t pos, const StringView& str) const;
+
+    size_t find(const StringView& str, size_t pos = 0) const;
+    size_t find_first_of(char c, size_t pos = 0) const;
+    size_t find_first_of(const StringView& str, size_t pos = 0) const;
+    size_t find_first_not_of(const StringView& str, size_t pos = 0) const;
+
+    // Returns the next token and removes it, together with the delimiting
+    // char after it, from the front of the view. Returns an empty view at
+    // the end.
+    StringView tok(const StringView& delim);
+};
+
 class String {
     static constexpr size_t SHORT_STRING_LENGTH = 20;
 
@@ -16,19 +57,26 @@ class String {
     size_t len;
 
     size_t save_index; // For strtok.
-    friend String strtok(String& str, const String& delim);
+    friend StringView strtok(String& str, const StringView& delim);
+    friend class StringView;
+
+    // Take over the contents of "str" and leave it empty.
+    void steal(String& str);
 
 public:
     static const size_t npos = (size_t)-1;
 
     /// Constructors etc.
     String();
-    String(char *s);
+    String(const char *s);
+    explicit String(const StringView& str);
     String(const String& str);
+    String(String&& str);
 
     ~String();
 
     String& operator =(const String& str);
+    String& operator =(String&& str);
 
     operator const char*();
 
@@ -77,12 +125,13 @@ public:
     /// String operations.
     // Compare this string, starting at "pos", with "str".
     // "pos" is checked for validity.
-    bool compare(size_t pos, const String& str) const;
+    bool compare(size_t pos, const StringView& str) const;
 
-    size_t find(const String& str, size_t pos = 0) const;
+    size_t find(const StringView& str, size_t pos = 0) const;
     size_t find_first_of(char c, size_t pos = 0) const;
-    size_t find_first_of(const String& str, size_t pos = 0) const;
-    String tok(const String& delim);
+    size_t find_first_of(const StringView& str, size_t pos = 0) const;
+    // The returned view is only valid until the string is modified.
+    StringView tok(const StringView& delim);
 
     // Copy the string into "s".
     size_t copy(char *s, size_t len, size_t pos = 0) const;
@@ -125,18 +174,22 @@ public:
     Iterator end() { return Iterator(); }
 };
 
-size_t strlen(const char *s);
+inline StringView::StringView(const String& str)
+    : ptr(str.use_heap ? str.data : str.short_data), len(str.len) {}
+
+// Returns a pointer to the first "c" in the "len" chars at "s", or nullptr.
+const char *memchr(const char *s, char c, size_t len);
 
 char *strcpy(char *dest, const char *src);
 char *strncpy(char *dest, const char *src, size_t size);
 
-int strcmp(const String& str1, const String& str2);
-bool streq(const String& str1, const String& str2);
+int strcmp(const StringView& str1, const StringView& str2);
+bool streq(const StringView& str1, const StringView& str2);
 
-// Returns an empty String at the end.
-String strtok(String& str, const String& delim);
+// Returns an empty view at the end.
+StringView strtok(String& str, const StringView& delim);
 
 // Base 0 means "figure it out yourself" (only 2, 8, 10, 16).
 // Supported bases are [2, 36].
 // Returns SSIZE_MAX on overflow.
-long strtol(const String& str, bool *error = nullptr, int base = 0);
+long strtol(const StringView& str, bool *error = nullptr, int base = 0);
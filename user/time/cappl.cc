@@ -14,13 +14,15 @@ extern Thread *victim;
 void ClockApplication::action() {
     Guarded_Bell::sleep(1000);
     Guarded_Scheduler::kill(victim);
+    Guarded_Scheduler::join(victim);
+    delete victim;
     Guarded_Scheduler::exit();
 
     for (;;) {
         //DBG << "Clock_App " << id << ": action " << flush;
-        rtc.update_time();
+        rtc.resync();
         dout_clock.reset();
-        dout_clock << rtc << flush;
+        dout_clock << rtc.now() << flush;
     }
 }
 
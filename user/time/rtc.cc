@@ -4,10 +4,13 @@
 #include "machine/ioapic.h"
 #include "machine/apicsystem.h"
 #include "debug/output.h"
+#include "debug/log.h"
 #include "user/time/time.h"
 #include "machine/ticketlock.h"
 #include "syscall/guarded_scheduler.h"
 #include "utils/math.h"
+#include "machine/cpu.h"
+#include "thread/workqueue.h"
 
 RTC rtc;
 
@@ -15,9 +18,31 @@ int32_t RTC::get_freq() const {
     return hz;
 }
 
+Time RTC::now() const {
+    Time t;
+    unsigned int seq;
+    do {
+        seq = time_lock.read_begin();
+        t = time;
+    } while (time_lock.read_retry(seq));
+    return t;
+}
+
+int16_t RTC::get_timezone() const {
+    return now().timezone;
+}
+
+void RTC::set_timezone(int16_t zone) {
+    bool ints = CPU::disable_int();
+    time_lock.write_lock();
+    time.set_timezone(zone);
+    time_lock.write_unlock();
+    CPU::restore_int(ints);
+}
+
 void RTC::init(bool enable_update_irq, CMOS::IRQ_freq periodic_irq_freq) {
     hz = CMOS::init(enable_update_irq, periodic_irq_freq);
-    update_time();
+    resync();
 
     Plugbox::Vector rtc_vector = Plugbox::Vector::rtc;
     unsigned char   rtc_slot   = system.getIOAPICSlot(APICSystem::Device::rtc);
@@ -33,15 +58,26 @@ void RTC::init(bool enable_update_irq, CMOS::IRQ_freq periodic_irq_freq) {
 
 bool RTC::prologue() {
     if (is_update_irq()) {
-        increment_seconds();
+        time_lock.write_lock();
+        time.increment_seconds();
+        updates++;
+        time_lock.write_unlock();
         return true;
     }
     return false;
 }
 
-void RTC::epilogue() {
+// redraws the clock in a worker thread, which costs the epilogue only
+// queueing it.
+static void redraw(void *) {
     dout_clock.reset();
-    dout_clock << *this << flush;
+    dout_clock << rtc.now() << flush;
+}
+
+static Work redraw_work(redraw);
+
+void RTC::epilogue() {
+    workqueue.submit(&redraw_work);
 }
 
 bool RTC::is_updating() {
@@ -72,7 +108,7 @@ uint16_t RTC::get_real_year() {
 
 void RTC::set_value(CMOS::Offset offset, uint16_t value) {
     if (value > 99) {
-        DBG << "RTC: invalid value (> 99)" << endl;
+        LOG_WARN << "RTC: invalid value (> 99)" << endl;
         return;
     }
 
@@ -90,7 +126,7 @@ void RTC::set_weekday(uint16_t value) { return set_value(Offset::weekday, value)
 void RTC::set_century(uint16_t value) { return set_value(Offset::century, value); }
 
 void RTC::set_local_hour(uint16_t hour) {
-    long h = (hour - timezone) % 24;
+    long h = (hour - get_timezone()) % 24;
     while (h < 0) h += 24;
     set_hour(h);
 }
@@ -100,15 +136,33 @@ void RTC::set_real_year(uint16_t year) {
     set_year(year % 100);
 }
 
-void RTC::update_time() {
-    Time::second  = get_second();
-    Time::minute  = get_minute();
-    Time::hour    = get_hour();
-    Time::day     = get_day();
-    Time::month   = get_month();
-    Time::year    = get_year();
-    Time::weekday = get_weekday();
-    Time::century = get_century();
-
-    apply_timezone();
+void RTC::resync() {
+    for (;;) {
+        // all the slow port I/O happens before taking the lock. If the
+        // update interrupt advances the snapshot meanwhile, the reading may
+        // be older than the snapshot and is thrown away.
+        unsigned int seen = __atomic_load_n(&updates, __ATOMIC_ACQUIRE);
+        Time t(get_timezone());
+        t.second  = get_second();
+        t.minute  = get_minute();
+        t.hour    = get_hour();
+        t.day     = get_day();
+        t.month   = get_month();
+        t.year    = get_year();
+        t.weekday = get_weekday();
+        t.century = get_century();
+        t.apply_timezone();
+
+        bool ints = CPU::disable_int();
+        time_lock.write_lock();
+        bool fresh = updates == seen;
+        if (fresh) {
+            time = t;
+        }
+        time_lock.write_unlock();
+        CPU::restore_int(ints);
+        if (fresh) {
+            return;
+        }
+    }
 }
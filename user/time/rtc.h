@@ -3,20 +3,45 @@
 #include "user/time/cmos.h"
 #include "user/time/time.h"
 #include "guard/gate.h"
+#include "machine/seqlock.h"
 #include "types.h"
 
-class RTC : public CMOS, public Time, public Gate {
+/*
+ * The current local time is kept as a snapshot in memory: resync() reads it
+ * from the CMOS, and the update interrupt advances it by one second. Both
+ * write it under a seqlock, so now() returns a consistent copy on any CPU,
+ * without port I/O and without waiting for the RTC.
+ */
+class RTC : public CMOS, public Gate {
 	// Disallow copies and assignments.
 	RTC(const RTC&)            = delete;
 	RTC& operator=(const RTC&) = delete;
 
     int32_t hz;
 
+    Time time;
+    Seqlock time_lock;
+    // counts the update interrupts, so resync() notices one that came
+    // while it was reading the CMOS.
+    unsigned int updates;
+
 public:
-    RTC(int16_t timezone = 2) : Time(timezone), hz(-1) {}
+    RTC(int16_t timezone = 2) : hz(-1), time(timezone), updates(0) {}
 
     int32_t get_freq() const;
 
+    /*
+     * Returns the current local time.
+     */
+    Time now() const;
+
+    int16_t get_timezone() const;
+
+    /*
+     * Changes the timezone; the time changes with the next "resync".
+     */
+    void set_timezone(int16_t zone);
+
 	void init(bool enable_update_irq = true, CMOS::IRQ_freq periodic_irq_freq = freq_0hz);
 
     bool prologue() override;
@@ -71,7 +96,7 @@ public:
     uint16_t get_real_year();
 
     /*
-     * "update_time" should be called after using any of these methods.
+     * "resync" should be called after using any of these methods.
      */
     void set_value(CMOS::Offset offset, uint16_t value);
     void set_second(uint16_t value);
@@ -87,9 +112,9 @@ public:
     void set_real_year(uint16_t year);
 
     /*
-     * Set the member "time" to the current time by reading from the CMOS.
+     * Set the time snapshot to the current time by reading from the CMOS.
      */
-    void update_time();
+    void resync();
 };
 
 extern RTC rtc;